@@ -0,0 +1,6 @@
+# Benchmarks run on generated corpora, so results of different runs and machines are comparable.
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    Kernels \
+    Pipeline
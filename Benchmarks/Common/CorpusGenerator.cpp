@@ -0,0 +1,141 @@
+#include "CorpusGenerator.h"
+#include "Workers/TextEncoding.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace {
+
+    struct SAlphabet
+    {
+        uint firstCodePoint;
+        int lettersCount;
+    };
+
+    constexpr SAlphabet LatinAlphabet { 0x61, 26 };         // a-z
+    constexpr SAlphabet NonAsciiAlphabets[] {
+        { 0x430, 32 },                                      // Cyrillic а-я
+        { 0x3B1, 25 },                                      // Greek α-ω
+        { 0x4E00, 2000 }                                    // Frequent CJK unified ideographs
+    };
+
+    //! Returns the cumulative distribution normalized to one.
+    std::vector<double> normalized(std::vector<double> in_weights)
+    {
+        double sum = 0.0;
+        for (auto& weight : in_weights) {
+            sum += weight;
+            weight = sum;
+        }
+        for (auto& weight : in_weights) {
+            weight /= sum;
+        }
+        return in_weights;
+    }
+
+} // namespace
+
+CCorpusGenerator::CCorpusGenerator(const SSettings& in_settings)
+    : m_settings(in_settings)
+    , m_state(in_settings.seed)
+{
+    m_settings.vocabularySize = std::max(m_settings.vocabularySize, 1);
+    m_settings.maxWordLength = std::max(m_settings.maxWordLength, 1);
+
+    // Lengths are Poisson distributed and shifted by one, so every word has at least one letter.
+    std::vector<double> lengthWeights;
+    const double lambda = std::max(m_settings.meanWordLength - 1.0, 0.0);
+    double weight = std::exp(-lambda);
+    double weightsSum = 0.0;
+    for (int length = 1; length <= m_settings.maxWordLength; ++length) {
+        lengthWeights.push_back(length == m_settings.maxWordLength ? std::max(1.0 - weightsSum, 0.0) : weight);
+        weightsSum += weight;
+        weight *= lambda / length;
+    }
+    const std::vector<double> lengthsDistribution = normalized(lengthWeights);
+
+    const int nonAsciiAlphabetsCount = static_cast<int>(std::size(NonAsciiAlphabets));
+    for (int i = 0; i < m_settings.vocabularySize; ++i) {
+        const int length = sample(lengthsDistribution) + 1;
+        const SAlphabet alphabet = nextUniform() < m_settings.nonAsciiWordsShare
+                ? NonAsciiAlphabets[nextRandom() % nonAsciiAlphabetsCount] : LatinAlphabet;
+        QByteArray word;
+        for (int j = 0; j < length; ++j) {
+            TextEncoding::AppendUtf8(alphabet.firstCodePoint + static_cast<uint>(nextRandom() % alphabet.lettersCount), word);
+        }
+        m_vocabulary.push_back(word);
+    }
+
+    std::vector<double> wordsWeights;
+    for (int rank = 1; rank <= m_settings.vocabularySize; ++rank) {
+        wordsWeights.push_back(1.0 / std::pow(static_cast<double>(rank), m_settings.zipfExponent));
+    }
+    m_wordsDistribution = normalized(wordsWeights);
+}
+
+QByteArray CCorpusGenerator::generate(qint64 in_size)
+{
+    QByteArray text;
+    text.reserve(static_cast<int>(std::min(in_size + m_settings.maxWordLength * 4 + 1, static_cast<qint64>(0x7FFFFFFF))));
+    while (text.size() < in_size) {
+        appendWord(text);
+    }
+    return text;
+}
+
+void CCorpusGenerator::generate(qint64 in_size, int in_chunkSize, const std::function<void(const QByteArray&)>& in_onChunk)
+{
+    QByteArray chunk;
+    chunk.reserve(in_chunkSize + m_settings.maxWordLength * 4 + 1);
+    qint64 size = 0;
+    while (size < in_size) {
+        chunk.resize(0);
+        while (chunk.size() < in_chunkSize && size + chunk.size() < in_size) {
+            appendWord(chunk);
+        }
+        size += chunk.size();
+        in_onChunk(chunk);
+    }
+}
+
+quint64 CCorpusGenerator::nextRandom()
+{
+    quint64 value = (m_state += 0x9E3779B97F4A7C15ULL);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+double CCorpusGenerator::nextUniform()
+{
+    return static_cast<double>(nextRandom() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+int CCorpusGenerator::sample(const std::vector<double>& in_cumulativeDistribution)
+{
+    const auto it = std::upper_bound(std::begin(in_cumulativeDistribution), std::end(in_cumulativeDistribution), nextUniform());
+    return std::min(static_cast<int>(it - std::begin(in_cumulativeDistribution)), static_cast<int>(in_cumulativeDistribution.size()) - 1);
+}
+
+void CCorpusGenerator::appendWord(QByteArray& inout_text)
+{
+    // Words are capitalized at the beginning of sentences, sentences are separated by periods, lines end in about a dozen of words.
+    const bool isSentenceBegin = m_wordsCount % 17 == 0;
+    const QByteArray& word = m_vocabulary[sample(m_wordsDistribution)];
+    inout_text.append(word);
+    if (isSentenceBegin && !word.isEmpty() && word[0] >= 'a' && word[0] <= 'z') {
+        inout_text[inout_text.size() - word.size()] = static_cast<char>(word[0] - 'a' + 'A');
+    }
+
+    ++m_wordsCount;
+    if (m_wordsCount % 17 == 0) {
+        inout_text.append(". ");
+    } else if (m_wordsCount % 12 == 0) {
+        inout_text.append('\n');
+    } else if (nextRandom() % 16 == 0) {
+        inout_text.append(", ");
+    } else {
+        inout_text.append(' ');
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef CORPUSGENERATOR_H
+#define CORPUSGENERATOR_H
+
+#include <QByteArray>
+
+#include <functional>
+#include <vector>
+
+//! The CCorpusGenerator class generates synthetic UTF-8 text for benchmarks. Words are drawn from a generated vocabulary by the Zipf law,
+//! so the text resembles natural language: a few words are very frequent and most of them are rare. The generator uses its own random
+//! number generator and distributions, so the same settings give the same text on every platform and compiler.
+class CCorpusGenerator
+{
+public:
+    struct SSettings
+    {
+        quint64 seed { 1 };
+        int vocabularySize { 50000 };       //!< The number of distinct words in the vocabulary.
+        double zipfExponent { 1.0 };        //!< The skew of words' frequencies: the frequency of the word of rank r is proportional to 1 / r^s.
+        double meanWordLength { 5.0 };      //!< The mean of the Poisson distribution of words' lengths in characters.
+        int maxWordLength { 24 };           //!< The tail of the lengths' distribution beyond the maximum is added to the maximum's probability.
+        double nonAsciiWordsShare { 0.1 };  //!< The share of vocabulary words in Cyrillic, Greek and CJK letters, the rest are in Latin letters.
+    };
+
+    explicit CCorpusGenerator(const SSettings& in_settings);
+
+    const SSettings& settings() const { return m_settings; }
+
+    //! Generates the text of the given size in bytes. The text ends at a word's boundary, so it may be a few bytes longer.
+    QByteArray generate(qint64 in_size);
+
+    //! Generates the text of the given size by chunks of about the given size, so texts bigger than memory may be written to files.
+    void generate(qint64 in_size, int in_chunkSize, const std::function<void(const QByteArray&)>& in_onChunk);
+
+    //! Returns the vocabulary in rank order: the first word is the most frequent one.
+    const std::vector<QByteArray>& vocabulary() const { return m_vocabulary; }
+
+private:
+    //! Returns the next number of the SplitMix64 sequence.
+    quint64 nextRandom();
+
+    //! Returns the next uniformly distributed number in the [0, 1) range.
+    double nextUniform();
+
+    //! Returns the index of the cumulative distribution's range, which the next uniform number falls into.
+    int sample(const std::vector<double>& in_cumulativeDistribution);
+
+    //! Appends the next word and the separator after it.
+    void appendWord(QByteArray& inout_text);
+
+    SSettings m_settings;
+    quint64 m_state { 0 };
+    std::vector<QByteArray> m_vocabulary;
+    std::vector<double> m_wordsDistribution;    //!< The cumulative distribution of vocabulary words' ranks.
+    quint64 m_wordsCount { 0 };
+};
+
+#endif // CORPUSGENERATOR_H
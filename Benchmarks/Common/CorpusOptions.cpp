@@ -0,0 +1,34 @@
+#include "CorpusOptions.h"
+
+#include <QCoreApplication>
+#include <QTextStream>
+
+void CorpusOptions::Add(QCommandLineParser& inout_parser)
+{
+    inout_parser.addOptions({
+        { "seed", QObject::tr("The seed of the corpus generator."), QObject::tr("seed"), "1" },
+        { "vocabulary", QObject::tr("The number of distinct words."), QObject::tr("count"), "50000" },
+        { "zipf", QObject::tr("The Zipf exponent of words' frequencies."), QObject::tr("exponent"), "1.0" },
+        { "mean-length", QObject::tr("The mean word length in characters."), QObject::tr("length"), "5.0" },
+        { "max-length", QObject::tr("The maximum word length in characters."), QObject::tr("length"), "24" },
+        { "non-ascii", QObject::tr("The share of words in non-ASCII letters from 0 to 1."), QObject::tr("share"), "0.1" }
+    });
+}
+
+bool CorpusOptions::Read(const QCommandLineParser& in_parser, CCorpusGenerator::SSettings& out_settings)
+{
+    bool isSeedOk = false, isVocabularyOk = false, isZipfOk = false, isMeanLengthOk = false, isMaxLengthOk = false, isNonAsciiOk = false;
+    out_settings.seed = in_parser.value("seed").toULongLong(&isSeedOk);
+    out_settings.vocabularySize = in_parser.value("vocabulary").toInt(&isVocabularyOk);
+    out_settings.zipfExponent = in_parser.value("zipf").toDouble(&isZipfOk);
+    out_settings.meanWordLength = in_parser.value("mean-length").toDouble(&isMeanLengthOk);
+    out_settings.maxWordLength = in_parser.value("max-length").toInt(&isMaxLengthOk);
+    out_settings.nonAsciiWordsShare = in_parser.value("non-ascii").toDouble(&isNonAsciiOk);
+    if (!isSeedOk || !isVocabularyOk || !isZipfOk || !isMeanLengthOk || !isMaxLengthOk || !isNonAsciiOk
+            || out_settings.vocabularySize <= 0 || out_settings.zipfExponent < 0.0 || out_settings.meanWordLength < 1.0
+            || out_settings.maxWordLength <= 0 || out_settings.nonAsciiWordsShare < 0.0 || out_settings.nonAsciiWordsShare > 1.0) {
+        QTextStream(stderr) << QString("%1: invalid corpus options\n").arg(QCoreApplication::applicationName());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,19 @@
+#ifndef CORPUSOPTIONS_H
+#define CORPUSOPTIONS_H
+
+#include "CorpusGenerator.h"
+
+#include <QCommandLineParser>
+
+//! Command line options of the corpus generator shared by benchmarks.
+namespace CorpusOptions {
+
+    void Add(QCommandLineParser& inout_parser);
+
+    //! Reads settings of the corpus generator from the parsed options.
+    //! @return false if any value is invalid, the error is written to the standard error.
+    bool Read(const QCommandLineParser& in_parser, CCorpusGenerator::SSettings& out_settings);
+
+} // namespace CorpusOptions
+
+#endif // CORPUSOPTIONS_H
@@ -0,0 +1,13 @@
+#ifndef PROCESSMEMORY_H
+#define PROCESSMEMORY_H
+
+#include <QtGlobal>
+
+namespace ProcessMemory {
+
+    //! Returns the peak resident set size of the process in bytes since it has been started, or -1 if it isn't available.
+    qint64 PeakResidentSetSize();
+
+} // namespace ProcessMemory
+
+#endif // PROCESSMEMORY_H
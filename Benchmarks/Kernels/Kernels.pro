@@ -0,0 +1,31 @@
+QT       = core concurrent
+
+CONFIG += c++17 console allocation_profiling
+CONFIG -= app_bundle
+
+TARGET = textanalyzer-kernels-benchmark
+TEMPLATE = app
+
+include(../../Core/Core.pri)
+
+INCLUDEPATH += $$PWD/..
+
+SOURCES += \
+    ../Common/CorpusGenerator.cpp \
+    ../Common/CorpusOptions.cpp \
+    main.cpp
+
+HEADERS += \
+    ../Common/CorpusGenerator.h \
+    ../Common/CorpusOptions.h
+
+CONFIG(debug, debug|release) {
+    win32: DESTDIR = Debug
+} else {
+    win32: DESTDIR = Release
+}
+
+!isEmpty(DESTDIR) {
+    OBJECTS_DIR = $${DESTDIR}/obj
+    MOC_DIR = $${DESTDIR}/moc
+}
@@ -0,0 +1,423 @@
+#include "CommonData.h"
+#include "Common/CorpusGenerator.h"
+#include "Common/CorpusOptions.h"
+#include "Workers/AllocationProfiler.h"
+#include "Workers/LetterCombinationsEnumerator.h"
+#include "Workers/StringInterner.h"
+#include "Workers/TextAnalyzer.h"
+#include "Workers/TextEncoding.h"
+#include "Workers/TopKHeap.h"
+#include "Workers/WordsBatch.h"
+#include "Workers/WordTokenizer.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <QTextStream>
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace {
+
+    // QString::SkipEmptyParts is deprecated since Qt 5.14, which has introduced Qt::SkipEmptyParts.
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    constexpr auto SkipEmptyParts = Qt::SkipEmptyParts;
+#else
+    constexpr auto SkipEmptyParts = QString::SkipEmptyParts;
+#endif
+
+    struct SKernelResult
+    {
+        QString name;
+        QString operation;          //!< The unit of work, which per-operation values are measured in.
+        int iterations { 0 };
+        double nsPerByte { 0.0 };   //!< Nanoseconds per byte of the corpus, zero if the kernel doesn't depend on the corpus size.
+        double nsPerOperation { 0.0 };
+        double allocationsPerOperation { 0.0 };
+        double allocatedBytesPerOperation { 0.0 };
+    };
+
+    //! A letter combination enumerated in advance, so the dictionary kernel measures interning only.
+    struct SEnumeratedLetterCombination
+    {
+        int offset;             //!< The offset in the data of enumerated letter combinations. Words batches are refilled by other kernels.
+        int size;
+        quint64 hash;
+        quint64 wordCount;      //!< The number of occurrences of the word, which the letter combination belongs to.
+    };
+
+    //! The comparison of the CommonData::elceSpaceSaving engine's top with exact counts.
+    struct SAccuracyResult
+    {
+        int checkedCount { 0 };             //!< Letter combinations of the approximate top.
+        int violationsCount { 0 };          //!< Counts, which exact counts aren't within their error bounds, or error bounds above the guaranteed one.
+        quint64 maxError { 0 };             //!< The maximum overestimation of an exact count.
+        quint64 guaranteedError { 0 };      //!< The total letter combinations count divided by the number of counters.
+        int exactTopFoundCount { 0 };       //!< Letter combinations of the exact top, which are in the approximate top.
+    };
+
+    //! Runs the kernel once to warm up caches and buffers, then repeats it for at least the given time.
+    //! @param in_bytesCount [in] - the corpus bytes processed by one run of the kernel.
+    //! @param in_operationsCount [in] - operations made by one run of the kernel.
+    SKernelResult measure(const QString& in_name, const QString& in_operation, quint64 in_bytesCount, quint64 in_operationsCount,
+                          int in_minTime, const std::function<void()>& in_kernel)
+    {
+        in_kernel();
+
+        const auto allocationsBefore = AllocationProfiler::Snapshot();
+        QElapsedTimer timer;
+        timer.start();
+        int iterations = 0;
+        do {
+            in_kernel();
+            ++iterations;
+        } while (timer.elapsed() < in_minTime);
+        const double nanoseconds = static_cast<double>(timer.nsecsElapsed());
+        const auto allocationsAfter = AllocationProfiler::Snapshot();
+
+        SKernelResult result;
+        result.name = in_name;
+        result.operation = in_operation;
+        result.iterations = iterations;
+        const double bytesCount = static_cast<double>(in_bytesCount) * iterations;
+        const double operationsCount = std::max(static_cast<double>(in_operationsCount) * iterations, 1.0);
+        result.nsPerByte = bytesCount ? nanoseconds / bytesCount : 0.0;
+        result.nsPerOperation = nanoseconds / operationsCount;
+        result.allocationsPerOperation = (allocationsAfter.allocationsCount - allocationsBefore.allocationsCount) / operationsCount;
+        result.allocatedBytesPerOperation = (allocationsAfter.allocatedBytes - allocationsBefore.allocatedBytes) / operationsCount;
+        return result;
+    }
+
+    //! Splits the text to words and counts them as the file reader does.
+    void fillWordsBatch(const QByteArray& in_text, CWordTokenizer& inout_tokenizer, QByteArray& inout_lowerCaseWord, CWordsBatch& out_batch)
+    {
+        out_batch.clear();
+        auto onWord = [&inout_lowerCaseWord, &out_batch](const char* in_word, int in_wordSize){
+            inout_lowerCaseWord.resize(0);
+            TextEncoding::AppendLowerCase(in_word, in_wordSize, inout_lowerCaseWord);
+            out_batch.addWord(inout_lowerCaseWord.constData(), inout_lowerCaseWord.size());
+        };
+        inout_tokenizer.feed(in_text.constData(), in_text.size(), onWord);
+        inout_tokenizer.finish(onWord);
+    }
+
+    QJsonObject toJson(const SKernelResult& in_result)
+    {
+        return {
+            { "name", in_result.name },
+            { "operation", in_result.operation },
+            { "iterations", in_result.iterations },
+            { "nsPerByte", in_result.nsPerByte },
+            { "nsPerOperation", in_result.nsPerOperation },
+            { "allocationsPerOperation", in_result.allocationsPerOperation },
+            { "allocatedBytesPerOperation", in_result.allocatedBytesPerOperation }
+        };
+    }
+
+    //! Counts the words batch by the CommonData::elceSpaceSaving engine and checks the top against exact counts of the dictionary.
+    SAccuracyResult checkSpaceSavingAccuracy(const CWordsBatch& in_batch, qint64 in_approximationMemoryBudget, const CStringInterner& in_dictionary,
+                                             const std::vector<quint64>& in_counts)
+    {
+        auto wordsBatchQueue = QSharedPointer<CWordsBatchQueue>::create();
+        CTextAnalyzerWorker textAnalyzer;
+        textAnalyzer.setWordsBatchQueue(wordsBatchQueue);
+        textAnalyzer.setEngine(CommonData::elceSpaceSaving);
+        textAnalyzer.setApproximationMemoryBudget(in_approximationMemoryBudget);
+
+        // Signals are delivered directly, since the analyzer runs in this thread.
+        WordsVector topLetterCombinations;
+        WordsVector errorBounds;
+        quint64 totalLetterCombinationsCount = 0;
+        QObject::connect(&textAnalyzer, &CTextAnalyzerWorker::textAnalyzingFinished, [&topLetterCombinations](const WordsVector& in_top){
+            topLetterCombinations = in_top;
+        });
+        QObject::connect(&textAnalyzer, &CTextAnalyzerWorker::topLetterCombinationsErrorBoundsUpdated, [&errorBounds](const WordsVector& in_errorBounds){
+            errorBounds = in_errorBounds;
+        });
+        QObject::connect(&textAnalyzer, &CTextAnalyzerWorker::totalLetterCombinationsCountUpdated, [&totalLetterCombinationsCount](quint64 in_count){
+            totalLetterCombinationsCount = in_count;
+        });
+
+        auto wordsBatch = wordsBatchQueue->acquire();
+        wordsBatch->merge(in_batch);
+        wordsBatchQueue->push(std::move(wordsBatch));
+        wordsBatchQueue->close();
+        textAnalyzer.processQueue();
+        textAnalyzer.finishTextAnalyzing();
+        const quint64 countersCount = std::max<quint64>(textAnalyzer.dictionarySize(), 1);
+        textAnalyzer.finishProcessing();
+
+        SAccuracyResult result;
+        result.checkedCount = topLetterCombinations.size();
+        result.guaranteedError = totalLetterCombinationsCount / countersCount;
+        QSet<QString> approximateTop;
+        for (int i = 0; i < topLetterCombinations.size(); ++i) {
+            const QByteArray letterCombination = topLetterCombinations[i].first.toUtf8();
+            const quint32 id = in_dictionary.find(letterCombination.constData(), letterCombination.size(),
+                                                  CStringInterner::hash(letterCombination.constData(), letterCombination.size()));
+            const quint64 exactCount = id != CStringInterner::InvalidId ? in_counts[id] : 0;
+            const quint64 count = topLetterCombinations[i].second;
+            const quint64 errorBound = i < errorBounds.size() ? errorBounds[i].second : 0;
+            if (exactCount > count || count - exactCount > errorBound || errorBound > result.guaranteedError) {
+                ++result.violationsCount;
+            }
+            result.maxError = std::max(result.maxError, count - std::min(count, exactCount));
+            approximateTop.insert(topLetterCombinations[i].first);
+        }
+
+        std::vector<quint32> ids(in_counts.size());
+        for (quint32 id = 0; id < ids.size(); ++id) {
+            ids[id] = id;
+        }
+        const size_t exactTopCount = std::min(ids.size(), static_cast<size_t>(CommonData::TopLetterCombinationsCount));
+        std::partial_sort(std::begin(ids), std::begin(ids) + exactTopCount, std::end(ids), [&in_counts](quint32 lhs, quint32 rhs){
+            return in_counts[lhs] > in_counts[rhs];
+        });
+        for (size_t i = 0; i < exactTopCount; ++i) {
+            if (approximateTop.contains(QString::fromUtf8(in_dictionary.data(ids[i]), in_dictionary.size(ids[i])))) {
+                ++result.exactTopFoundCount;
+            }
+        }
+        return result;
+    }
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+    QCoreApplication::setApplicationName("textanalyzer-kernels-benchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QObject::tr("Measures kernels of text analyzing on the generated corpus: nanoseconds per corpus byte, "
+                                                 "nanoseconds and heap allocations per operation."));
+    parser.addHelpOption();
+    parser.addOptions({
+        { "size", QObject::tr("The corpus size in megabytes, 16 by default."), QObject::tr("megabytes"), "16" },
+        { "min-time", QObject::tr("The minimum measuring time of a kernel in milliseconds."), QObject::tr("milliseconds"), "500" },
+        { "engines", QObject::tr("Comma separated letter combinations engines, which count words of the corpus: enumerator, suffix-automaton "
+                                 "or space-saving."), QObject::tr("engines"), "enumerator,suffix-automaton,space-saving" },
+        { "approximation-memory", QObject::tr("The memory budget of the space-saving engine in megabytes."), QObject::tr("megabytes"),
+          QString::number(CSpaceSaving::DefaultMemoryBudget / (1024 * 1024)) },
+        { "json", QObject::tr("Writes results as JSON to the file, \"-\" is the standard output."), QObject::tr("file") }
+    });
+    CorpusOptions::Add(parser);
+    parser.process(application);
+
+    CCorpusGenerator::SSettings settings;
+    if (!CorpusOptions::Read(parser, settings)) {
+        return 1;
+    }
+    const qint64 corpusSize = parser.value("size").toLongLong() * 1024 * 1024;
+    const int minTime = parser.value("min-time").toInt();
+    const qint64 approximationMemoryBudget = parser.value("approximation-memory").toLongLong() * 1024 * 1024;
+    QVector<CommonData::ELetterCombinationsEngine> engines;
+    bool isEnginesOk = true;
+    for (const auto& engineName : parser.value("engines").split(',', SkipEmptyParts)) {
+        engines.push_back(CommonData::elceEnumerator);
+        isEnginesOk = isEnginesOk && CommonData::ParseLetterCombinationsEngineName(engineName, engines.back());
+    }
+    if (corpusSize <= 0 || corpusSize > 1024 * 1024 * 1024 || minTime < 0 || !isEnginesOk || approximationMemoryBudget <= 0) {
+        QTextStream(stderr) << "textanalyzer-kernels-benchmark: invalid options\n";
+        return 1;
+    }
+
+    // Allocations of all threads are counted, kernels run in this thread only.
+    AllocationProfiler::SetEnabled(true);
+
+    CCorpusGenerator generator(settings);
+    const QByteArray text = generator.generate(corpusSize);
+    const quint64 textSize = static_cast<quint64>(text.size());
+
+    // Prepare inputs of the kernels: words of the corpus, their letter combinations and the stream of counts' updates.
+    CWordTokenizer tokenizer;
+    QByteArray lowerCaseWord;
+    CWordsBatch batch;
+    fillWordsBatch(text, tokenizer, lowerCaseWord, batch);
+    quint64 wordsCount = 0;
+    std::vector<int> enumeratedWords;
+    for (int i = 0; i < batch.size(); ++i) {
+        wordsCount += batch.wordCount(i);
+        if (TextEncoding::CharactersCount(batch.wordData(i), batch.wordSize(i)) >= CommonData::MinLetterCombinationLength) {
+            enumeratedWords.push_back(i);
+        }
+    }
+
+    CLetterCombinationsEnumerator enumerator;
+    CStringInterner dictionary;
+    std::vector<quint64> counts;
+    std::vector<quint32> updates;
+    std::vector<SEnumeratedLetterCombination> enumeratedLetterCombinations;
+    QByteArray enumeratedLetterCombinationsData;
+    quint64 letterCombinationsCount = 0;
+    for (const auto i : enumeratedWords) {
+        enumerator.enumerate(batch.wordData(i), batch.wordSize(i));
+        for (const auto& letterCombination : enumerator.letterCombinations()) {
+            enumeratedLetterCombinations.push_back({ enumeratedLetterCombinationsData.size(), letterCombination.size, letterCombination.hash,
+                                                     batch.wordCount(i) });
+            enumeratedLetterCombinationsData.append(batch.wordData(i) + letterCombination.offset, letterCombination.size);
+            bool isAdded = false;
+            const quint32 id = dictionary.intern(batch.wordData(i) + letterCombination.offset, letterCombination.size, letterCombination.hash, isAdded);
+            if (isAdded) {
+                counts.push_back(0);
+            }
+            counts[id] += batch.wordCount(i);
+            updates.push_back(id);
+        }
+        letterCombinationsCount += enumerator.letterCombinations().size();
+    }
+
+    std::vector<SKernelResult> results;
+    quint64 tokenizedWordsCount = 0;
+    results.push_back(measure("tokenizer", "word", textSize, wordsCount, minTime, [&text, &tokenizer, &tokenizedWordsCount](){
+        tokenizedWordsCount = 0;
+        auto onWord = [&tokenizedWordsCount](const char*, int){ ++tokenizedWordsCount; };
+        tokenizer.feed(text.constData(), text.size(), onWord);
+        tokenizer.finish(onWord);
+    }));
+    results.push_back(measure("wordsBatch", "word", textSize, wordsCount, minTime, [&text, &tokenizer, &lowerCaseWord, &batch](){
+        fillWordsBatch(text, tokenizer, lowerCaseWord, batch);
+    }));
+    results.push_back(measure("enumerator", "distinct word", textSize, enumeratedWords.size(), minTime, [&batch, &enumeratedWords, &enumerator](){
+        for (const auto i : enumeratedWords) {
+            enumerator.enumerate(batch.wordData(i), batch.wordSize(i));
+        }
+    }));
+    // Letter combinations are enumerated once before measuring, the enumeration is measured by its own kernel.
+    results.push_back(measure("dictionary", "letter combination", textSize, letterCombinationsCount, minTime,
+                              [&dictionary, &counts, &enumeratedLetterCombinations, &enumeratedLetterCombinationsData](){
+        dictionary.clear();
+        std::fill(std::begin(counts), std::end(counts), 0);
+        const char* data = enumeratedLetterCombinationsData.constData();
+        for (const auto& letterCombination : enumeratedLetterCombinations) {
+            bool isAdded = false;
+            const quint32 id = dictionary.intern(data + letterCombination.offset, letterCombination.size, letterCombination.hash, isAdded);
+            counts[id] += letterCombination.wordCount;
+        }
+    }));
+
+    // Engines count the whole corpus as one words batch, the analyzer's state is cleared after every run.
+    auto wordsBatchQueue = QSharedPointer<CWordsBatchQueue>::create();
+    for (const auto engine : engines) {
+        CTextAnalyzerWorker textAnalyzer;
+        textAnalyzer.setWordsBatchQueue(wordsBatchQueue);
+        textAnalyzer.setEngine(engine);
+        textAnalyzer.setApproximationMemoryBudget(approximationMemoryBudget);
+        results.push_back(measure("engine:" + CommonData::LetterCombinationsEngineName(engine), "distinct word", textSize, batch.size(), minTime,
+                                  [&wordsBatchQueue, &textAnalyzer, &batch](){
+            wordsBatchQueue->reset();
+            auto wordsBatch = wordsBatchQueue->acquire();
+            wordsBatch->merge(batch);
+            wordsBatchQueue->push(std::move(wordsBatch));
+            wordsBatchQueue->close();
+            textAnalyzer.processQueue();
+            textAnalyzer.finishTextAnalyzing();
+            textAnalyzer.finishProcessing();
+        }));
+    }
+
+    // The dictionary kernel has left exact counts, which the space-saving engine's error bounds are checked against.
+    const bool isAccuracyChecked = engines.contains(CommonData::elceSpaceSaving);
+    const SAccuracyResult accuracy = isAccuracyChecked ? checkSpaceSavingAccuracy(batch, approximationMemoryBudget, dictionary, counts)
+                                                       : SAccuracyResult();
+
+    // Counts are only growing in the analyzer, so updates are replayed on counts, which are restored before every run.
+    std::vector<quint64> updatedCounts(counts.size());
+    auto isBetter = [&updatedCounts, &dictionary](quint32 lhs, quint32 rhs){
+        return updatedCounts[lhs] != updatedCounts[rhs] ? updatedCounts[lhs] > updatedCounts[rhs] : dictionary.isLess(lhs, rhs);
+    };
+    CTopKHeap top(CommonData::TopLetterCombinationsCount);
+    results.push_back(measure("topK", "update", textSize, updates.size(), minTime, [&](){
+        std::fill(std::begin(updatedCounts), std::end(updatedCounts), 0);
+        top.clear();
+        for (const auto id : updates) {
+            ++updatedCounts[id];
+            top.update(id, isBetter);
+        }
+    }));
+
+    // The top is rebuilt and converted to strings every time it changes.
+    constexpr int rebuildsCount = 1000;
+    WordsVector topLetterCombinations;
+    results.push_back(measure("topKRebuild", "rebuild", 0, rebuildsCount, minTime, [&](){
+        for (int i = 0; i < rebuildsCount; ++i) {
+            topLetterCombinations.clear();
+            for (const auto id : top.sortedIds(isBetter)) {
+                topLetterCombinations.push_back(QPair(QString::fromUtf8(dictionary.data(id), dictionary.size(id)), updatedCounts[id]));
+            }
+        }
+    }));
+
+    const QString jsonFileName = parser.value("json");
+    QTextStream table(jsonFileName == "-" ? stderr : stdout);
+    table << QString("Corpus: %1 bytes, %2 words, %3 distinct words, the most common letter combination is \"%4\"\n")
+             .arg(textSize).arg(tokenizedWordsCount).arg(batch.size()).arg(topLetterCombinations.isEmpty() ? QString() : topLetterCombinations.front().first);
+    table << QString("%1 %2 %3 %4 %5\n").arg("kernel", -24).arg("ns/byte", 10).arg("ns/op", 10).arg("allocs/op", 10).arg("operation");
+    for (const auto& result : results) {
+        table << QString("%1 %2 %3 %4 %5\n").arg(result.name, -24).arg(result.nsPerByte, 10, 'f', 3).arg(result.nsPerOperation, 10, 'f', 2)
+                 .arg(result.allocationsPerOperation, 10, 'f', 4).arg(result.operation);
+    }
+    if (isAccuracyChecked) {
+        table << QString("space-saving accuracy: %1 of %2 counts out of bounds, maximum error %3, guaranteed error %4, %5 of the exact top %6 found\n")
+                 .arg(accuracy.violationsCount).arg(accuracy.checkedCount).arg(accuracy.maxError).arg(accuracy.guaranteedError)
+                 .arg(accuracy.exactTopFoundCount).arg(CommonData::TopLetterCombinationsCount);
+    }
+    table.flush();
+
+    if (!jsonFileName.isEmpty()) {
+        QJsonArray kernels;
+        for (const auto& result : results) {
+            kernels.append(toJson(result));
+        }
+        const QJsonObject corpus {
+            { "seed", QString::number(settings.seed) },
+            { "vocabularySize", settings.vocabularySize },
+            { "zipfExponent", settings.zipfExponent },
+            { "meanWordLength", settings.meanWordLength },
+            { "maxWordLength", settings.maxWordLength },
+            { "nonAsciiWordsShare", settings.nonAsciiWordsShare },
+            { "bytes", static_cast<double>(textSize) },
+            { "words", static_cast<double>(wordsCount) },
+            { "distinctWords", batch.size() }
+        };
+        QJsonObject report {
+            { "benchmark", "kernels" },
+            { "timestamp", QDateTime::currentDateTimeUtc().toString(Qt::ISODate) },
+            { "qtVersion", qVersion() },
+            { "corpus", corpus },
+            { "approximationMemory", static_cast<double>(approximationMemoryBudget) },
+            { "kernels", kernels }
+        };
+        if (isAccuracyChecked) {
+            report["spaceSavingAccuracy"] = QJsonObject {
+                { "checked", accuracy.checkedCount },
+                { "violations", accuracy.violationsCount },
+                { "maxError", static_cast<double>(accuracy.maxError) },
+                { "guaranteedError", static_cast<double>(accuracy.guaranteedError) },
+                { "exactTopFound", accuracy.exactTopFoundCount }
+            };
+        }
+
+        QFile file(jsonFileName);
+        const bool isOpen = jsonFileName == "-" ? file.open(stdout, QIODevice::WriteOnly) : file.open(QIODevice::WriteOnly);
+        if (!isOpen || file.write(QJsonDocument(report).toJson()) < 0) {
+            QTextStream(stderr) << QString("textanalyzer-kernels-benchmark: %1 can't be written\n").arg(jsonFileName);
+            return 1;
+        }
+    }
+
+    // Counts out of their error bounds break the engine's guarantee rather than slow it down.
+    if (accuracy.violationsCount) {
+        QTextStream(stderr) << "textanalyzer-kernels-benchmark: space-saving counts are out of their error bounds\n";
+        return 2;
+    }
+    return 0;
+}
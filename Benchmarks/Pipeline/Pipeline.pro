@@ -0,0 +1,35 @@
+QT       = core concurrent
+
+CONFIG += c++17 console allocation_profiling
+CONFIG -= app_bundle
+
+TARGET = textanalyzer-pipeline-benchmark
+TEMPLATE = app
+
+include(../../Core/Core.pri)
+
+INCLUDEPATH += $$PWD/..
+
+SOURCES += \
+    ../Common/CorpusGenerator.cpp \
+    ../Common/CorpusOptions.cpp \
+    ../Common/ProcessMemory.cpp \
+    main.cpp
+
+HEADERS += \
+    ../Common/CorpusGenerator.h \
+    ../Common/CorpusOptions.h \
+    ../Common/ProcessMemory.h
+
+win32: LIBS += -lpsapi
+
+CONFIG(debug, debug|release) {
+    win32: DESTDIR = Debug
+} else {
+    win32: DESTDIR = Release
+}
+
+!isEmpty(DESTDIR) {
+    OBJECTS_DIR = $${DESTDIR}/obj
+    MOC_DIR = $${DESTDIR}/moc
+}
@@ -0,0 +1,373 @@
+#include "CommonData.h"
+#include "Common/CorpusGenerator.h"
+#include "Common/CorpusOptions.h"
+#include "Common/ProcessMemory.h"
+#include "Workers/AllocationProfiler.h"
+#include "Workers/FileReader.h"
+#include "Workers/TextAnalyzer.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+    constexpr double MiB = 1024.0 * 1024.0;
+
+    // QString::SkipEmptyParts is deprecated since Qt 5.14, which has introduced Qt::SkipEmptyParts.
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    constexpr auto SkipEmptyParts = Qt::SkipEmptyParts;
+#else
+    constexpr auto SkipEmptyParts = QString::SkipEmptyParts;
+#endif
+
+    //! Parses the size with the optional K, M or G suffix, e.g. "64M".
+    //! @return zero if the size is invalid.
+    qint64 parseSize(const QString& in_size)
+    {
+        static const QMap<QChar, qint64> units { { 'K', 1024LL }, { 'M', 1024LL * 1024 }, { 'G', 1024LL * 1024 * 1024 } };
+        QString size = in_size.trimmed().toUpper();
+        qint64 unit = 1;
+        if (!size.isEmpty() && units.contains(size.back())) {
+            unit = units[size.back()];
+            size.chop(1);
+        }
+        bool isOk = false;
+        const double value = size.toDouble(&isOk);
+        return isOk && value > 0 ? static_cast<qint64>(value * unit) : 0;
+    }
+
+    //! Generates the corpus file unless it already exists. Corpora are named by settings, so they are reused by later runs.
+    //! @return an empty string if the file couldn't be written.
+    QString corpusFile(const QString& in_directory, const CCorpusGenerator::SSettings& in_settings, qint64 in_size)
+    {
+        const QString fileName = QDir(in_directory).filePath(QString("corpus-%1-%2-%3-%4-%5-%6-%7.txt").arg(in_settings.seed)
+            .arg(in_settings.vocabularySize).arg(in_settings.zipfExponent).arg(in_settings.meanWordLength).arg(in_settings.maxWordLength)
+            .arg(in_settings.nonAsciiWordsShare).arg(in_size));
+        if (QFileInfo(fileName).size() >= in_size) {
+            return fileName;
+        }
+
+        QFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly)) {
+            return QString();
+        }
+        bool isWritten = true;
+        CCorpusGenerator generator(in_settings);
+        generator.generate(in_size, 4 * 1024 * 1024, [&file, &isWritten](const QByteArray& in_chunk){
+            isWritten = isWritten && file.write(in_chunk) == in_chunk.size();
+        });
+        if (!isWritten) {
+            file.remove();
+            return QString();
+        }
+        return fileName;
+    }
+
+    //! Analyzes the file in this process, as the command line tool does, and writes the measurement as a JSON line to the standard output.
+    //! Every file is measured by a separate process, so the peak memory belongs to one run. The peak RSS includes pages of the memory-mapped
+    //! file, which grow with the file rather than with the analyzer's memory, so the peak heap is measured by the allocation hooks as well.
+    //! @param in_approximationMemoryBudget [in] - the memory budget of the CommonData::elceSpaceSaving engine in bytes.
+    //! @param in_spillMemoryBudget [in] - the memory budget of the enumerator's dictionary in bytes, zero disables spilling.
+    int measure(const QString& in_fileName, int in_threadsCount, CommonData::ELetterCombinationsEngine in_engine, qint64 in_approximationMemoryBudget,
+                qint64 in_spillMemoryBudget)
+    {
+        qRegisterMetaType<WordsVector>("WordsVector");
+
+        auto wordsBatchQueue = QSharedPointer<CWordsBatchQueue>::create();
+        CFileReaderWorker fileReader;
+        fileReader.setWordsBatchQueue(wordsBatchQueue);
+        CTextAnalyzerWorker textAnalyzer;
+        textAnalyzer.setWordsBatchQueue(wordsBatchQueue);
+        textAnalyzer.setEngine(in_engine);
+        textAnalyzer.setApproximationMemoryBudget(in_approximationMemoryBudget);
+        textAnalyzer.setSpillMemoryBudget(in_spillMemoryBudget);
+        if (in_threadsCount > 1) {
+            fileReader.setReadingMode(CommonData::efrmParallel);
+            fileReader.setThreadsCount(in_threadsCount);
+            textAnalyzer.setShardsCount(in_threadsCount);
+        }
+
+        QElapsedTimer timer;
+        int status = CommonData::efrsFileProcessingInterrupted;
+        qint64 firstTopUpdateTime = -1;
+        quint64 wordsCount = 0;
+        QObject::connect(&fileReader, &CFileReaderWorker::statusChanged, [&status](int in_status){
+            status = in_status;
+        });
+        QObject::connect(&textAnalyzer, &CTextAnalyzerWorker::topLetterCombinationsUpdated, [&timer, &firstTopUpdateTime](){
+            if (firstTopUpdateTime < 0) {
+                firstTopUpdateTime = timer.nsecsElapsed();
+            }
+        });
+        QObject::connect(&textAnalyzer, &CTextAnalyzerWorker::wordsProcessedCountUpdated, [&wordsCount](quint64 in_count){
+            wordsCount = in_count;
+        });
+
+        AllocationProfiler::Reset();
+        timer.start();
+        auto reading = QtConcurrent::run([&fileReader, &in_fileName](){ fileReader.process(in_fileName); });
+        textAnalyzer.processQueue();
+        reading.waitForFinished();
+        if (status != CommonData::efrsFileProcessingFinished) {
+            QTextStream(stderr) << QString("textanalyzer-pipeline-benchmark: %1 can't be read\n").arg(in_fileName);
+            return 1;
+        }
+        textAnalyzer.finishTextAnalyzing();
+        const qint64 wallTime = timer.nsecsElapsed();
+
+        const qint64 size = QFileInfo(in_fileName).size();
+        const QJsonObject result {
+            { "bytes", static_cast<double>(size) },
+            { "wallTime", wallTime / 1e9 },
+            { "throughput", size / MiB / (wallTime / 1e9) },
+            { "peakRss", static_cast<double>(ProcessMemory::PeakResidentSetSize()) },
+            { "peakHeap", static_cast<double>(AllocationProfiler::Snapshot().peakLiveBytes) },
+            { "dictionarySize", static_cast<double>(textAnalyzer.dictionarySize()) },
+            { "words", static_cast<double>(wordsCount) },
+            { "firstTopUpdateTime", firstTopUpdateTime < 0 ? -1.0 : firstTopUpdateTime / 1e9 }
+        };
+        QTextStream(stdout) << QJsonDocument(result).toJson(QJsonDocument::Compact) << '\n';
+        return 0;
+    }
+
+    //! Returns the names of the report-level settings, which differ from the baseline's ones. Results measured with different settings
+    //! aren't comparable. Settings missing in baselines written by older versions aren't compared.
+    QStringList findDifferentSettings(const QJsonObject& in_settings, const QJsonObject& in_baseline)
+    {
+        QStringList differentSettings;
+        for (auto it = in_settings.constBegin(); it != in_settings.constEnd(); ++it) {
+            if (in_baseline.contains(it.key()) && in_baseline[it.key()] != it.value()) {
+                differentSettings << it.key();
+            }
+        }
+        return differentSettings;
+    }
+
+    //! Compares runs with the baseline runs of the same sizes and engines. Baselines without engines were measured by the enumerator.
+    //! @return descriptions of regressions beyond the tolerance.
+    QStringList findRegressions(const QJsonArray& in_runs, const QJsonArray& in_baselineRuns, double in_tolerance)
+    {
+        QStringList regressions;
+        for (const auto& runValue : in_runs) {
+            const QJsonObject run = runValue.toObject();
+            for (const auto& baselineRunValue : in_baselineRuns) {
+                const QJsonObject baselineRun = baselineRunValue.toObject();
+                if (baselineRun["size"].toDouble() != run["size"].toDouble()
+                        || baselineRun["engine"].toString(CommonData::LetterCombinationsEngineName(CommonData::elceEnumerator)) != run["engine"].toString()) {
+                    continue;
+                }
+                const double throughput = run["throughput"].toDouble();
+                const double baselineThroughput = baselineRun["throughput"].toDouble();
+                if (throughput < baselineThroughput * (1.0 - in_tolerance)) {
+                    regressions << QString("%1 %2: throughput %3 MiB/s, the baseline is %4 MiB/s").arg(run["sizeLabel"].toString(), run["engine"].toString())
+                                   .arg(throughput, 0, 'f', 1).arg(baselineThroughput, 0, 'f', 1);
+                }
+                // The peak RSS isn't compared, since it includes pages of the memory-mapped file. Baselines without the peak heap
+                // were written by older versions, their memory isn't compared.
+                const double peakHeap = run["peakHeap"].toDouble();
+                const double baselinePeakHeap = baselineRun["peakHeap"].toDouble();
+                if (baselinePeakHeap > 0 && peakHeap > baselinePeakHeap * (1.0 + in_tolerance)) {
+                    regressions << QString("%1 %2: peak heap %3 MiB, the baseline is %4 MiB").arg(run["sizeLabel"].toString(), run["engine"].toString())
+                                   .arg(peakHeap / MiB, 0, 'f', 1).arg(baselinePeakHeap / MiB, 0, 'f', 1);
+                }
+            }
+        }
+        return regressions;
+    }
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+    QCoreApplication::setApplicationName("textanalyzer-pipeline-benchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QObject::tr("Runs the file reader and the text analyzer on generated corpora of the given sizes and measures "
+                                                 "wall time, throughput, peak memory, the dictionary size and the time to the first top update. "
+                                                 "Exits with code 2 if results regress from the baseline beyond the tolerance."));
+    parser.addHelpOption();
+    parser.addOptions({
+        { "sizes", QObject::tr("Comma separated corpus sizes with K, M or G suffixes."), QObject::tr("sizes"), "1M,16M,256M" },
+        { { "j", "threads" }, QObject::tr("The number of threads reading files and counting letter combinations."), QObject::tr("count"), "1" },
+        { "engines", QObject::tr("Comma separated letter combinations engines: enumerator, suffix-automaton or space-saving. "
+                                 "Every corpus is measured by every engine."), QObject::tr("engines"), "enumerator" },
+        { "approximation-memory", QObject::tr("The memory budget of the space-saving engine with a K, M or G suffix."), QObject::tr("size"),
+          QString("%1M").arg(CSpaceSaving::DefaultMemoryBudget / (1024 * 1024)) },
+        { "spill-memory", QObject::tr("The memory budget of the enumerator's dictionary with a K, M or G suffix, counts beyond it are written to disk. "
+                                      "Spilling is disabled if it isn't set."), QObject::tr("size") },
+        { "corpus-dir", QObject::tr("The directory, where generated corpora are kept for later runs. They are removed if it isn't set."),
+          QObject::tr("directory") },
+        { "json", QObject::tr("Writes results as JSON to the file, which may be used as a baseline."), QObject::tr("file") },
+        { "baseline", QObject::tr("Compares results with the baseline written by --json."), QObject::tr("file") },
+        { "tolerance", QObject::tr("The allowed relative regression of throughput and peak heap memory."), QObject::tr("share"), "0.1" }
+    });
+    QCommandLineOption measureOption("measure", QObject::tr("Measures the analysis of the file in this process."), QObject::tr("file"));
+    measureOption.setFlags(QCommandLineOption::HiddenFromHelp);
+    parser.addOption(measureOption);
+    QCommandLineOption engineOption("engine", QObject::tr("The letter combinations engine of the measured analysis."), QObject::tr("engine"), "enumerator");
+    engineOption.setFlags(QCommandLineOption::HiddenFromHelp);
+    parser.addOption(engineOption);
+    CorpusOptions::Add(parser);
+    parser.process(application);
+
+    const int threadsCount = std::max(parser.value("threads").toInt(), 1);
+    const qint64 approximationMemoryBudget = parseSize(parser.value("approximation-memory"));
+    const qint64 spillMemoryBudget = parser.isSet("spill-memory") ? parseSize(parser.value("spill-memory")) : 0;
+    if (!approximationMemoryBudget || (parser.isSet("spill-memory") && !spillMemoryBudget)) {
+        QTextStream(stderr) << "textanalyzer-pipeline-benchmark: invalid memory budget\n";
+        return 1;
+    }
+    if (parser.isSet(measureOption)) {
+        auto engine = CommonData::elceEnumerator;
+        if (!CommonData::ParseLetterCombinationsEngineName(parser.value(engineOption), engine)) {
+            QTextStream(stderr) << QString("textanalyzer-pipeline-benchmark: invalid engine %1\n").arg(parser.value(engineOption));
+            return 1;
+        }
+        return measure(parser.value(measureOption), threadsCount, engine, approximationMemoryBudget, spillMemoryBudget);
+    }
+
+    CCorpusGenerator::SSettings settings;
+    if (!CorpusOptions::Read(parser, settings)) {
+        return 1;
+    }
+    bool isToleranceOk = false;
+    const double tolerance = parser.value("tolerance").toDouble(&isToleranceOk);
+    QVector<QPair<QString, qint64>> sizes;
+    for (const auto& sizeLabel : parser.value("sizes").split(',', SkipEmptyParts)) {
+        sizes.push_back({ sizeLabel.trimmed(), parseSize(sizeLabel) });
+        if (!sizes.back().second) {
+            QTextStream(stderr) << QString("textanalyzer-pipeline-benchmark: invalid size %1\n").arg(sizeLabel);
+            return 1;
+        }
+    }
+    QVector<CommonData::ELetterCombinationsEngine> engines;
+    for (const auto& engineName : parser.value("engines").split(',', SkipEmptyParts)) {
+        engines.push_back(CommonData::elceEnumerator);
+        if (!CommonData::ParseLetterCombinationsEngineName(engineName, engines.back())) {
+            QTextStream(stderr) << QString("textanalyzer-pipeline-benchmark: invalid engine %1\n").arg(engineName);
+            return 1;
+        }
+    }
+    if (!isToleranceOk || tolerance < 0.0 || sizes.isEmpty() || engines.isEmpty()) {
+        QTextStream(stderr) << "textanalyzer-pipeline-benchmark: invalid options\n";
+        return 1;
+    }
+
+    const QJsonObject settingsReport {
+        { "threads", threadsCount },
+        { "approximationMemory", static_cast<double>(approximationMemoryBudget) },
+        { "spillMemory", static_cast<double>(spillMemoryBudget) },
+        { "seed", QString::number(settings.seed) },
+        { "vocabularySize", settings.vocabularySize },
+        { "zipfExponent", settings.zipfExponent },
+        { "meanWordLength", settings.meanWordLength },
+        { "maxWordLength", settings.maxWordLength },
+        { "nonAsciiWordsShare", settings.nonAsciiWordsShare }
+    };
+
+    QJsonArray baselineRuns;
+    if (parser.isSet("baseline")) {
+        QFile baselineFile(parser.value("baseline"));
+        if (!baselineFile.open(QIODevice::ReadOnly)) {
+            QTextStream(stderr) << QString("textanalyzer-pipeline-benchmark: %1 can't be read\n").arg(baselineFile.fileName());
+            return 1;
+        }
+        const QJsonObject baseline = QJsonDocument::fromJson(baselineFile.readAll()).object();
+        const QStringList differentSettings = findDifferentSettings(settingsReport, baseline);
+        if (differentSettings.isEmpty()) {
+            baselineRuns = baseline["runs"].toArray();
+        } else {
+            QTextStream(stderr) << QString("textanalyzer-pipeline-benchmark: the comparison with the baseline is skipped, its settings differ: %1\n")
+                                   .arg(differentSettings.join(", "));
+        }
+    }
+
+    std::unique_ptr<QTemporaryDir> temporaryDir;
+    QString corpusDirectory = parser.value("corpus-dir");
+    if (corpusDirectory.isEmpty()) {
+        temporaryDir = std::make_unique<QTemporaryDir>(QDir(QDir::tempPath()).filePath("TextAnalyzer-corpora-XXXXXX"));
+        corpusDirectory = temporaryDir->path();
+    }
+    if (!QDir().mkpath(corpusDirectory)) {
+        QTextStream(stderr) << QString("textanalyzer-pipeline-benchmark: %1 can't be created\n").arg(corpusDirectory);
+        return 1;
+    }
+
+    QTextStream table(stdout);
+    table << QString("%1 %2 %3 %4 %5 %6 %7 %8\n").arg("size", -8).arg("engine", -16).arg("MiB/s", 10).arg("wall, s", 10).arg("peak RSS, MiB", 14)
+             .arg("peak heap, MiB", 15).arg("dictionary", 12).arg("first top, s", 13);
+    table.flush();
+    QJsonArray runs;
+    for (const auto& size : sizes) {
+        const QString fileName = corpusFile(corpusDirectory, settings, size.second);
+        if (fileName.isEmpty()) {
+            QTextStream(stderr) << QString("textanalyzer-pipeline-benchmark: the %1 corpus can't be written\n").arg(size.first);
+            return 1;
+        }
+
+        for (const auto engine : engines) {
+            const QString engineName = CommonData::LetterCombinationsEngineName(engine);
+            QProcess process;
+            process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+            QStringList arguments { "--measure", fileName, "--threads", QString::number(threadsCount), "--engine", engineName,
+                                    "--approximation-memory", QString::number(approximationMemoryBudget) };
+            if (spillMemoryBudget) {
+                arguments << "--spill-memory" << QString::number(spillMemoryBudget);
+            }
+            process.start(QCoreApplication::applicationFilePath(), arguments);
+            process.waitForFinished(-1);
+            QJsonObject run = QJsonDocument::fromJson(process.readAllStandardOutput().trimmed()).object();
+            if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0 || run.isEmpty()) {
+                QTextStream(stderr) << QString("textanalyzer-pipeline-benchmark: the %1 corpus measurement by the %2 engine failed\n")
+                                       .arg(size.first, engineName);
+                return 1;
+            }
+            run["size"] = static_cast<double>(size.second);
+            run["sizeLabel"] = size.first;
+            run["engine"] = engineName;
+            runs.append(run);
+
+            table << QString("%1 %2 %3 %4 %5 %6 %7 %8\n").arg(size.first, -8).arg(engineName, -16).arg(run["throughput"].toDouble(), 10, 'f', 1)
+                     .arg(run["wallTime"].toDouble(), 10, 'f', 3).arg(run["peakRss"].toDouble() / MiB, 14, 'f', 1)
+                     .arg(run["peakHeap"].toDouble() / MiB, 15, 'f', 1).arg(static_cast<qint64>(run["dictionarySize"].toDouble()), 12)
+                     .arg(run["firstTopUpdateTime"].toDouble(), 13, 'f', 3);
+            table.flush();
+        }
+    }
+
+    if (parser.isSet("json")) {
+        QJsonObject report = settingsReport;
+        report["benchmark"] = "pipeline";
+        report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+        report["qtVersion"] = qVersion();
+        report["runs"] = runs;
+        QFile file(parser.value("json"));
+        if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(report).toJson()) < 0) {
+            QTextStream(stderr) << QString("textanalyzer-pipeline-benchmark: %1 can't be written\n").arg(file.fileName());
+            return 1;
+        }
+    }
+
+    const QStringList regressions = findRegressions(runs, baselineRuns, tolerance);
+    for (const auto& regression : regressions) {
+        QTextStream(stderr) << "Regression: " << regression << '\n';
+    }
+    return regressions.isEmpty() ? 0 : 2;
+}
@@ -0,0 +1,28 @@
+QT       = core concurrent
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = textanalyzer-cli
+TEMPLATE = app
+
+include(../Core/Core.pri)
+
+SOURCES += \
+    main.cpp
+
+CONFIG(debug, debug|release) {
+    win32: DESTDIR = Debug
+} else {
+    win32: DESTDIR = Release
+}
+
+!isEmpty(DESTDIR) {
+    OBJECTS_DIR = $${DESTDIR}/obj
+    MOC_DIR = $${DESTDIR}/moc
+}
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,441 @@
+#include "CommonData.h"
+#include "Workers/AllocationProfiler.h"
+#include "Workers/FileReader.h"
+#include "Workers/PipelineMetrics.h"
+#include "Workers/TextAnalyzer.h"
+#include "Workers/Tracing.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QThread>
+#include <QTimer>
+#include <QtConcurrent>
+
+#include <atomic>
+#include <condition_variable>
+#include <csignal>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+    struct SSettings
+    {
+        int topLetterCombinationsCount { CommonData::TopLetterCombinationsCount };
+        int minLetterCombinationLength { CommonData::MinLetterCombinationLength };
+        int maxLetterCombinationLength { CommonData::MaxLetterCombinationLength };
+        int threadsCount { 1 };
+        int metricsInterval { 0 };  //!< The interval of live metrics in milliseconds, zero disables them.
+        CommonData::ELetterCombinationsEngine engine { CommonData::elceEnumerator };
+        int approximationMemoryBudget { static_cast<int>(CSpaceSaving::DefaultMemoryBudget / (1024 * 1024)) };  //!< In megabytes.
+        int spillMemoryBudget { 0 };    //!< The memory budget of the dictionary in megabytes, zero disables spilling.
+        bool isFollowMode { false };
+        bool isCheckpointed { false };  //!< Checkpoints of files are written, so their interrupted analysis may be resumed.
+        bool isResumed { false };       //!< The interrupted analysis of files is resumed from their checkpoints.
+    };
+
+    //! Writes samples of live metrics of the file's analyzing to the standard error as JSON lines at the given interval.
+    //! The text analyzer runs in the calling thread, so samples are taken in the writer's own thread. The last sample is written when it's destroyed.
+    class CMetricsWriter
+    {
+    public:
+        CMetricsWriter(CPipelineMetrics& inout_pipelineMetrics, const QString& in_fileName, int in_interval)
+            : m_pipelineMetrics(inout_pipelineMetrics)
+            , m_fileName(in_fileName)
+            , m_interval(in_interval)
+        {
+            m_pipelineMetrics.reset();
+            m_thread = std::thread([this](){ run(); });
+        }
+
+        ~CMetricsWriter()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_isStop = true;
+            }
+            m_stopCondition.notify_one();
+            m_thread.join();
+            write();
+        }
+
+    private:
+        void run()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!m_stopCondition.wait_for(lock, std::chrono::milliseconds(m_interval), [this](){ return m_isStop; })) {
+                write();
+            }
+        }
+
+        void write()
+        {
+            auto sample = m_pipelineMetrics.sample().toJson();
+            sample.insert("file", m_fileName);
+            QTextStream(stderr) << QJsonDocument(sample).toJson(QJsonDocument::Compact) << '\n';
+        }
+
+        CPipelineMetrics& m_pipelineMetrics;
+        QString m_fileName;
+        int m_interval;
+        std::mutex m_mutex;
+        std::condition_variable m_stopCondition;
+        bool m_isStop { false };
+        std::thread m_thread;
+    };
+
+    //! Parses the integer option's value, which must be at least the given minimum.
+    bool parseOption(const QCommandLineParser& in_parser, const QString& in_name, int in_minValue, int& out_value)
+    {
+        if (!in_parser.isSet(in_name)) {
+            return true;
+        }
+        bool isOk = false;
+        const int value = in_parser.value(in_name).toInt(&isOk);
+        if (!isOk || value < in_minValue) {
+            QTextStream(stderr) << QString("textanalyzer-cli: invalid value of --%1: %2\n").arg(in_name, in_parser.value(in_name));
+            return false;
+        }
+        out_value = value;
+        return true;
+    }
+
+    //! Writes the updated top of the followed file to the standard output as a JSON line, so it's streamed while data is appended.
+    void writeTopUpdate(const QString& in_fileName, const WordsVector& in_top, quint64 in_totalLetterCombinationsCount)
+    {
+        QJsonArray top;
+        for (const auto& letterCombination : in_top) {
+            const double percentage = in_totalLetterCombinationsCount ? (letterCombination.second * 100.0) / in_totalLetterCombinationsCount : 0.0;
+            top.append(QJsonObject {
+                { "letterCombination", letterCombination.first },
+                { "count", static_cast<double>(letterCombination.second) },
+                { "percentage", percentage }
+            });
+        }
+        const QJsonObject update {
+            { "file", in_fileName },
+            { "totalLetterCombinations", static_cast<double>(in_totalLetterCombinationsCount) },
+            { "top", top }
+        };
+        QTextStream output(stdout);
+        output.setCodec("UTF-8");
+        output << QJsonDocument(update).toJson(QJsonDocument::Compact) << '\n';
+    }
+
+    //! It's set by SIGINT or SIGTERM to finish following of the file.
+    std::atomic<bool> isInterrupted { false };
+
+    //! Follows the file until SIGINT or SIGTERM. The file reader runs in its own thread, which event loop delivers changes of the file,
+    //! the text analyzer runs in the calling thread. The file reader is moved back to the calling thread when following finishes.
+    void followFile(const QString& in_fileName, CFileReaderWorker& inout_fileReader, CTextAnalyzerWorker& inout_textAnalyzer)
+    {
+        isInterrupted = false;
+        auto onSignal = [](int){ isInterrupted = true; };
+        const auto previousInterruptHandler = std::signal(SIGINT, onSignal);
+        const auto previousTerminateHandler = std::signal(SIGTERM, onSignal);
+
+        // The signal handler only sets the flag, it's checked in the file reader's thread.
+        QThread readerThread;
+        readerThread.setObjectName("File reader");
+        QTimer interruptTimer;
+        interruptTimer.setInterval(100);
+        QObject::connect(&interruptTimer, &QTimer::timeout, &inout_fileReader, [&inout_fileReader](){
+            if (isInterrupted) {
+                inout_fileReader.stopProcessing();
+            }
+        });
+        inout_fileReader.moveToThread(&readerThread);
+        interruptTimer.moveToThread(&readerThread);
+        readerThread.start();
+        QMetaObject::invokeMethod(&inout_fileReader, [&inout_fileReader, &interruptTimer, &in_fileName](){
+            interruptTimer.start();
+            inout_fileReader.process(in_fileName);
+        }, Qt::QueuedConnection);
+
+        inout_textAnalyzer.processQueue();
+
+        QThread* callingThread = QThread::currentThread();
+        QMetaObject::invokeMethod(&inout_fileReader, [&inout_fileReader, &interruptTimer, callingThread](){
+            interruptTimer.stop();
+            interruptTimer.moveToThread(callingThread);
+            inout_fileReader.moveToThread(callingThread);
+        }, Qt::BlockingQueuedConnection);
+        readerThread.quit();
+        readerThread.wait();
+        std::signal(SIGINT, previousInterruptHandler);
+        std::signal(SIGTERM, previousTerminateHandler);
+    }
+
+    //! Stops reading of the file on SIGINT or SIGTERM, so the text analyzer writes the checkpoint of the interrupted analysis.
+    //! The file reader and the text analyzer are busy, so the flag set by the signal handler is checked in the watcher's own thread.
+    class CInterruptWatcher
+    {
+    public:
+        explicit CInterruptWatcher(CFileReaderWorker& inout_fileReader)
+            : m_fileReader(inout_fileReader)
+        {
+            isInterrupted = false;
+            auto onSignal = [](int){ isInterrupted = true; };
+            m_previousInterruptHandler = std::signal(SIGINT, onSignal);
+            m_previousTerminateHandler = std::signal(SIGTERM, onSignal);
+            m_thread = std::thread([this](){ run(); });
+        }
+
+        ~CInterruptWatcher()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_isStop = true;
+            }
+            m_stopCondition.notify_one();
+            m_thread.join();
+            std::signal(SIGINT, m_previousInterruptHandler);
+            std::signal(SIGTERM, m_previousTerminateHandler);
+        }
+
+    private:
+        void run()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!m_stopCondition.wait_for(lock, std::chrono::milliseconds(100), [this](){ return m_isStop; })) {
+                if (isInterrupted) {
+                    m_fileReader.stopProcessing();
+                    return;
+                }
+            }
+        }
+
+        CFileReaderWorker& m_fileReader;
+        std::mutex m_mutex;
+        std::condition_variable m_stopCondition;
+        bool m_isStop { false };
+        std::thread m_thread;
+        void (*m_previousInterruptHandler)(int) { nullptr };
+        void (*m_previousTerminateHandler)(int) { nullptr };
+    };
+
+    //! Analyzes the file as the GUI does: the file reader runs in the thread pool, the text analyzer runs in the calling thread.
+    //! The followed file is analyzed by followFile(). The interrupted analysis is resumed from the file's checkpoint if it's set in the settings.
+    //! @return false if the file couldn't be read.
+    bool analyzeFile(const QString& in_fileName, const SSettings& in_settings, CFileReaderWorker& inout_fileReader, CTextAnalyzerWorker& inout_textAnalyzer,
+                     CWordsBatchQueue& inout_wordsBatchQueue, WordsVector& out_top, quint64& out_totalLetterCombinationsCount)
+    {
+        inout_wordsBatchQueue.reset();
+        if (in_settings.isCheckpointed) {
+            // Without --resume the file is analyzed from the beginning, so its previous checkpoint is removed.
+            CCheckpoint checkpoint;
+            checkpoint.setFileName(CCheckpoint::DefaultFileName(in_fileName));
+            if (!in_settings.isResumed) {
+                checkpoint.remove();
+            }
+            inout_textAnalyzer.setCheckpointFileName(checkpoint.fileName());
+            qint64 resumeOffset = 0;
+            if (inout_textAnalyzer.resumeFromCheckpoint(in_fileName, resumeOffset)) {
+                QTextStream(stderr) << QString("textanalyzer-cli: %1: resumed from byte %2\n").arg(in_fileName).arg(resumeOffset);
+            }
+            inout_fileReader.setStartOffset(resumeOffset);
+        }
+        int status = CommonData::efrsFileProcessingInterrupted;
+        const auto statusConnection = QObject::connect(&inout_fileReader, &CFileReaderWorker::statusChanged, [&status](int in_status){
+            status = in_status;
+        });
+        const auto totalConnection = QObject::connect(&inout_textAnalyzer, &CTextAnalyzerWorker::totalLetterCombinationsCountUpdated,
+                                                      [&out_totalLetterCombinationsCount](quint64 in_count){
+            out_totalLetterCombinationsCount = in_count;
+        });
+        const auto topConnection = QObject::connect(&inout_textAnalyzer, &CTextAnalyzerWorker::textAnalyzingFinished, [&out_top](const WordsVector& in_top){
+            out_top = in_top;
+        });
+        // The total is updated before the top, so it's current when the top is written.
+        QMetaObject::Connection topUpdateConnection;
+        if (in_settings.isFollowMode) {
+            topUpdateConnection = QObject::connect(&inout_textAnalyzer, &CTextAnalyzerWorker::topLetterCombinationsUpdated,
+                                                   [&in_fileName, &out_totalLetterCombinationsCount](const WordsVector& in_top){
+                writeTopUpdate(in_fileName, in_top, out_totalLetterCombinationsCount);
+            });
+        }
+        const auto spillConnection = QObject::connect(&inout_textAnalyzer, &CTextAnalyzerWorker::dictionarySpillFailed,
+                                                      [&in_fileName](const QString& in_errorString){
+            QTextStream(stderr) << QString("textanalyzer-cli: %1: spilling is disabled, %2\n").arg(in_fileName, in_errorString);
+        });
+
+        if (in_settings.isFollowMode) {
+            followFile(in_fileName, inout_fileReader, inout_textAnalyzer);
+        } else {
+            std::unique_ptr<CInterruptWatcher> interruptWatcher;
+            if (in_settings.isCheckpointed) {
+                interruptWatcher = std::make_unique<CInterruptWatcher>(inout_fileReader);
+            }
+            auto reading = QtConcurrent::run([&inout_fileReader, &in_fileName](){ inout_fileReader.process(in_fileName); });
+            inout_textAnalyzer.processQueue();
+            reading.waitForFinished();
+        }
+        const bool isFinished = status == CommonData::efrsFileProcessingFinished;
+        if (isFinished) {
+            inout_textAnalyzer.finishTextAnalyzing();
+        }
+        inout_textAnalyzer.finishProcessing();
+
+        QObject::disconnect(statusConnection);
+        QObject::disconnect(totalConnection);
+        QObject::disconnect(topConnection);
+        QObject::disconnect(topUpdateConnection);
+        QObject::disconnect(spillConnection);
+        return isFinished;
+    }
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+    QCoreApplication::setApplicationName("textanalyzer-cli");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QObject::tr("Writes the most common letter combinations of text files to the standard output, one per line:\n"
+                                                 "letter combination, count and percentage separated by tabs. "
+                                                 "Lines are prefixed with the file name if several files are given."));
+    parser.addHelpOption();
+    parser.addOptions({
+        { { "n", "top" }, QObject::tr("The number of the most common letter combinations."), QObject::tr("count") },
+        { "min-length", QObject::tr("The minimum length of letter combinations in characters."), QObject::tr("length") },
+        { "max-length", QObject::tr("The maximum length of letter combinations in characters, 0 means unlimited."), QObject::tr("length") },
+        { { "j", "threads" }, QObject::tr("The number of threads reading files and counting letter combinations."), QObject::tr("count") },
+        { "engine", QObject::tr("The letter combinations counting engine: enumerator (by default), suffix-automaton or space-saving, "
+                                "which gives approximate counts in bounded memory."), QObject::tr("engine") },
+        { "approximation-memory", QObject::tr("The memory budget of the space-saving engine in megabytes, %1 by default.")
+                                  .arg(CSpaceSaving::DefaultMemoryBudget / (1024 * 1024)), QObject::tr("megabytes") },
+        { "spill-memory", QObject::tr("The memory budget of the enumerator's dictionary in megabytes. When it's reached, counts are written to disk "
+                                      "and merged at the end, the result stays exact. Spilling is disabled by default and with several threads."),
+          QObject::tr("megabytes") },
+        { "spill-dir", QObject::tr("The directory of counts written to disk, the system temporary directory by default."), QObject::tr("directory") },
+        { { "f", "follow" }, QObject::tr("Follows the file as it grows, like tail -f. Every change of the top is written as a JSON line: the file, "
+                                         "the total count of letter combinations and the top with counts and percentages. The final top is written "
+                                         "when it's interrupted by Ctrl+C. A truncated or rotated file is read from the beginning again. "
+                                         "Only one file may be followed.") },
+        { "checkpoint", QObject::tr("Writes checkpoints of every file's analysis to the temporary directory every %1 minutes and when it's interrupted "
+                                    "by Ctrl+C, so it may be resumed by --resume. A previous checkpoint of the file is removed. Checkpoints are written "
+                                    "by the enumerator engine in one thread while its dictionary isn't written to disk.")
+                                    .arg(CommonData::CheckpointInterval / (60 * 1000)) },
+        { "resume", QObject::tr("Resumes the interrupted analysis of every file from its checkpoint and writes checkpoints as --checkpoint does. "
+                                "A file without a valid checkpoint is analyzed from the beginning.") },
+        { "metrics", QObject::tr("Writes live metrics to the standard error as JSON lines at the given interval: read bytes, rates, "
+                                 "queued batches, dictionary size, cache hit rate, memory, progress and remaining time."), QObject::tr("milliseconds") },
+        { "trace", QObject::tr("Writes spans of the pipeline's threads to the file as Chrome trace-event JSON."), QObject::tr("file") },
+        { "allocations", QObject::tr("Accounts heap allocations by pipeline stages and writes the summary to the standard error.") }
+    });
+    parser.addPositionalArgument("files", QObject::tr("Text files to analyze."), "files...");
+    parser.process(application);
+
+    SSettings settings;
+    const QStringList fileNames = parser.positionalArguments();
+    if (fileNames.isEmpty()) {
+        parser.showHelp(1);
+    }
+    settings.isFollowMode = parser.isSet("follow");
+    if (settings.isFollowMode && fileNames.size() > 1) {
+        QTextStream(stderr) << "textanalyzer-cli: only one file may be followed\n";
+        return 1;
+    }
+    settings.isResumed = parser.isSet("resume");
+    settings.isCheckpointed = parser.isSet("checkpoint") || settings.isResumed;
+    if (!parseOption(parser, "top", 1, settings.topLetterCombinationsCount)
+            || !parseOption(parser, "min-length", 1, settings.minLetterCombinationLength)
+            || !parseOption(parser, "max-length", 0, settings.maxLetterCombinationLength)
+            || !parseOption(parser, "threads", 1, settings.threadsCount)
+            || !parseOption(parser, "metrics", 1, settings.metricsInterval)
+            || !parseOption(parser, "approximation-memory", 1, settings.approximationMemoryBudget)
+            || !parseOption(parser, "spill-memory", 0, settings.spillMemoryBudget)) {
+        return 1;
+    }
+    if (parser.isSet("engine") && !CommonData::ParseLetterCombinationsEngineName(parser.value("engine"), settings.engine)) {
+        QTextStream(stderr) << QString("textanalyzer-cli: invalid value of --engine: %1\n").arg(parser.value("engine"));
+        return 1;
+    }
+    // The followed file has no end to resume reading from, as in the GUI application.
+    if (settings.isCheckpointed && (settings.isFollowMode || settings.engine != CommonData::elceEnumerator || settings.threadsCount > 1)) {
+        QTextStream(stderr) << "textanalyzer-cli: checkpoints are written by the enumerator engine in one thread without --follow\n";
+        return 1;
+    }
+
+    qRegisterMetaType<WordsVector>("WordsVector");
+
+    auto wordsBatchQueue = QSharedPointer<CWordsBatchQueue>::create();
+    CFileReaderWorker fileReader;
+    fileReader.setWordsBatchQueue(wordsBatchQueue);
+    CTextAnalyzerWorker textAnalyzer;
+    textAnalyzer.setWordsBatchQueue(wordsBatchQueue);
+    textAnalyzer.setLetterCombinationsLengthRange(settings.minLetterCombinationLength, settings.maxLetterCombinationLength);
+    textAnalyzer.setTopLetterCombinationsCount(settings.topLetterCombinationsCount);
+    textAnalyzer.setEngine(settings.engine);
+    textAnalyzer.setApproximationMemoryBudget(settings.approximationMemoryBudget * 1024LL * 1024);
+    textAnalyzer.setSpillMemoryBudget(settings.spillMemoryBudget * 1024LL * 1024);
+    if (parser.isSet("spill-dir")) {
+        textAnalyzer.setSpillDirectory(parser.value("spill-dir"));
+    }
+    fileReader.setFollowMode(settings.isFollowMode);
+    if (settings.threadsCount > 1) {
+        fileReader.setReadingMode(CommonData::efrmParallel);
+        fileReader.setThreadsCount(settings.threadsCount);
+        textAnalyzer.setShardsCount(settings.threadsCount);
+    }
+    const QString traceFileName = parser.value("trace");
+    Tracing::SetEnabled(!traceFileName.isEmpty());
+    AllocationProfiler::SetEnabled(parser.isSet("allocations"));
+    if (parser.isSet("allocations") && !AllocationProfiler::IsAvailable()) {
+        QTextStream(stderr) << "textanalyzer-cli: allocations aren't accounted, the tool is built without CONFIG+=allocation_profiling\n";
+    }
+    QSharedPointer<CPipelineMetrics> pipelineMetrics;
+    if (settings.metricsInterval > 0) {
+        pipelineMetrics = QSharedPointer<CPipelineMetrics>::create();
+        pipelineMetrics->setWordsBatchQueue(wordsBatchQueue);
+        fileReader.setPipelineMetrics(pipelineMetrics);
+        textAnalyzer.setPipelineMetrics(pipelineMetrics);
+    }
+
+    QTextStream output(stdout);
+    output.setCodec("UTF-8");
+    int exitCode = 0;
+    for (const auto& fileName : fileNames) {
+        WordsVector top;
+        quint64 totalLetterCombinationsCount = 0;
+        std::unique_ptr<CMetricsWriter> metricsWriter;
+        if (pipelineMetrics) {
+            metricsWriter = std::make_unique<CMetricsWriter>(*pipelineMetrics, fileName, settings.metricsInterval);
+        }
+        const bool isAnalyzed = analyzeFile(fileName, settings, fileReader, textAnalyzer, *wordsBatchQueue, top, totalLetterCombinationsCount);
+        metricsWriter.reset();
+        if (settings.isCheckpointed && isInterrupted) {
+            QTextStream(stderr) << QString("textanalyzer-cli: %1: interrupted, the analysis may be resumed by --resume\n").arg(fileName);
+            exitCode = 1;
+            break;
+        }
+        if (!isAnalyzed) {
+            QTextStream(stderr) << QString("textanalyzer-cli: %1: the file can't be read\n").arg(fileName);
+            exitCode = 1;
+            continue;
+        }
+
+        const QString prefix = fileNames.size() > 1 ? fileName + '\t' : QString();
+        for (const auto& letterCombination : top) {
+            const double percentage = totalLetterCombinationsCount ? (letterCombination.second * 100.0) / totalLetterCombinationsCount : 0.0;
+            output << prefix << letterCombination.first << '\t' << letterCombination.second << '\t' << QString::number(percentage, 'f', 3) << "%\n";
+        }
+        output.flush();
+    }
+
+    if (AllocationProfiler::IsEnabled()) {
+        AllocationProfiler::SetEnabled(false);
+        QTextStream(stderr) << AllocationProfiler::Summary();
+    }
+    if (!traceFileName.isEmpty() && !Tracing::Write(traceFileName)) {
+        QTextStream(stderr) << QString("textanalyzer-cli: %1 can't be written\n").arg(traceFileName);
+        exitCode = 1;
+    }
+    return exitCode;
+}
@@ -2,27 +2,32 @@
 #define COMMONDATA_H
 
 #include <QString>
-#include <QColor>
+#include <QByteArray>
 #include <QDir>
 #include <QMap>
-#include <unordered_map>
 
-typedef QMap<QString, ulong> WordsMap;
+// Colors and style sheets are available in targets using Qt GUI only, so the core library and the command line tool don't depend on it.
+#ifdef QT_GUI_LIB
+#include <QColor>
+#endif
+
 typedef QVector<QPair<QString, quint64>> WordsVector;
-typedef std::vector<std::pair<quint64, std::pair<QString, quint64>>> DictionaryVector;                  //!< Dictionary vector of letter combinations as keys in hash representation.
-                                                                                                        //!< Value is combination of string representation of letter combination and its count.
-typedef std::unordered_map<quint64, std::pair<QString, quint64>> DictionaryMap;                         //!< Dictionary map of letter combinations as keys in hash representation.
-                                                                                                        //!< Value is combination of string representation of letter combination and its count.
-typedef std::unordered_map<quint64, std::unordered_map<quint64, quint64>> WordsLetterCombinationsMap;   //!< Contains letter combinations and their count (value) for words (key) in hash representation.
-typedef std::unordered_map<quint64, quint64> LetterCombinationsMap;                                     //!< Contains letter combinations (key) and their count (value) in hash representation.
 
 namespace CommonData {
 
     inline constexpr int TopLetterCombinationsCount = 10;
     inline constexpr int MinLetterCombinationLength = 4;
+    // Longer letter combinations aren't counted, it bounds the work per long token: a word of N characters has O(N * max length) combinations.
+    inline constexpr int MaxLetterCombinationLength = 64;
 
     inline constexpr int MaxLetterCombinationsTableColumns = 3;
 
+    // The minimum interval between checkpoints of text analyzing in milliseconds.
+    inline constexpr int CheckpointInterval = 5 * 60 * 1000;
+
+    // The interval between samples of live metrics of text analyzing in milliseconds.
+    inline constexpr int MetricsInterval = 500;
+
     inline constexpr int ButtonPaddingX = 5;
     inline constexpr int ButtonPaddingY = 5;
     inline constexpr int ButtonBorderWidth = 1;
@@ -35,7 +40,34 @@ namespace CommonData {
     {
         efrsFileOpenError = 0,
         efrsFileProcessingFinished,
-        efrsFileProcessingInterrupted
+        efrsFileProcessingInterrupted,
+        efrsFileResumeError         //!< Reading can't be resumed from the checkpoint's offset in the current reading mode or encoding.
+    };
+
+    enum EFileReadingMode
+    {
+        efrmStreamed = 0,           //!< Read the file by chunks into a buffer.
+        efrmMemoryMapped,           //!< Map the file into memory and split words straight out of the mapped pages.
+                                    //!< Falls back to efrmStreamed for pipes and other non-mappable inputs.
+        efrmParallel                //!< Map the file into memory, divide it into byte ranges aligned to words' boundaries and count words
+                                    //!< of the ranges in the thread pool. Falls back to efrmStreamed as efrmMemoryMapped does.
+    };
+
+    enum ETextEncoding
+    {
+        eteUtf8 = 0,
+        eteUtf16LittleEndian,
+        eteUtf16BigEndian,
+        eteLatin1
+    };
+
+    enum ELetterCombinationsEngine
+    {
+        elceEnumerator = 0,         //!< Enumerate letter combinations of every distinct word and count them in the dictionary as words arrive.
+        elceSuffixAutomaton,        //!< Build the suffix automaton of distinct words and count letter combinations when text analyzing finishes.
+                                    //!< It's linear in the vocabulary length, so long words don't slow it down, but the top isn't updated meanwhile.
+        elceSpaceSaving             //!< Count letter combinations approximately in the fixed memory budget. Counts are overestimated by at most
+                                    //!< the total letter combinations count divided by the number of counters, the bound is reported for every count.
     };
 
     enum ELetterCombinationsTableColumn {
@@ -51,6 +83,7 @@ namespace CommonData {
         etasTextAnalyzingInProgress
     };
 
+#ifdef QT_GUI_LIB
     static QColor DominantColor()
     {
         static QColor dominantColor(45, 127, 249);
@@ -138,6 +171,7 @@ namespace CommonData {
                      QString::number(qRound(ButtonPaddingY * scaleFactor)));
         return toolButtonStyleSheet;
     }
+#endif // QT_GUI_LIB
 
     static QString NormalizePath(const QString& path)
     {
@@ -152,6 +186,29 @@ namespace CommonData {
         return QDir::toNativeSeparators(dir.path());
     }
 
+    //! Returns the name of the letter combinations engine, which is used in command line options and reports.
+    static QString LetterCombinationsEngineName(ELetterCombinationsEngine in_engine)
+    {
+        switch (in_engine) {
+        case elceSuffixAutomaton: return QStringLiteral("suffix-automaton");
+        case elceSpaceSaving: return QStringLiteral("space-saving");
+        default: return QStringLiteral("enumerator");
+        }
+    }
+
+    //! Finds the letter combinations engine by its name.
+    //! @return false if the name is unknown.
+    static bool ParseLetterCombinationsEngineName(const QString& in_name, ELetterCombinationsEngine& out_engine)
+    {
+        for (const auto engine : { elceEnumerator, elceSuffixAutomaton, elceSpaceSaving }) {
+            if (in_name.trimmed() == LetterCombinationsEngineName(engine)) {
+                out_engine = engine;
+                return true;
+            }
+        }
+        return false;
+    }
+
     template <typename T>
     class asKeyValueRange
     {
@@ -0,0 +1,4 @@
+# Links the allocation hooks of AllocationProfiler, which replace the C allocator (the operator new outside glibc) of the program.
+# It's included by Core.pri if CONFIG contains allocation_profiling: the benchmarks add it, the GUI application and the command line tool
+# add it by qmake CONFIG+=allocation_profiling.
+SOURCES += $$PWD/../Workers/AllocationHooks.cpp
@@ -0,0 +1,16 @@
+# Links the core library. It's included by targets built on it.
+INCLUDEPATH += $$PWD/..
+DEPENDPATH += $$PWD/..
+
+CONFIG(debug, debug|release) {
+    win32: CORE_DESTDIR = Debug
+} else {
+    win32: CORE_DESTDIR = Release
+}
+CORE_LIB_DIR = $$shadowed($$PWD)/$${CORE_DESTDIR}
+
+LIBS += -L$${CORE_LIB_DIR} -lTextAnalyzerCore
+win32-msvc*: PRE_TARGETDEPS += $${CORE_LIB_DIR}/TextAnalyzerCore.lib
+else: PRE_TARGETDEPS += $${CORE_LIB_DIR}/libTextAnalyzerCore.a
+
+allocation_profiling: include(AllocationProfiling.pri)
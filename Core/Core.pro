@@ -0,0 +1,65 @@
+QT       = core concurrent
+
+CONFIG += c++17 staticlib
+
+TARGET = TextAnalyzerCore
+TEMPLATE = lib
+
+INCLUDEPATH += $$PWD/..
+
+SOURCES += \
+    ../Workers/AllocationProfiler.cpp \
+    ../Workers/Checkpoint.cpp \
+    ../Workers/DictionarySpill.cpp \
+    ../Workers/FileReader.cpp \
+    ../Workers/LetterCombinationsEnumerator.cpp \
+    ../Workers/PackedLetterCombinationsIndex.cpp \
+    ../Workers/PipelineMetrics.cpp \
+    ../Workers/ResultCache.cpp \
+    ../Workers/ResultIndex.cpp \
+    ../Workers/ShardedDictionary.cpp \
+    ../Workers/SpaceSaving.cpp \
+    ../Workers/StringInterner.cpp \
+    ../Workers/SuffixAutomaton.cpp \
+    ../Workers/TextAnalyzer.cpp \
+    ../Workers/TextEncoding.cpp \
+    ../Workers/Tracing.cpp \
+    ../Workers/WordsBatch.cpp \
+    ../Workers/WordsBatchQueue.cpp \
+    ../Workers/WordsCombinationsCache.cpp \
+    ../Workers/WordTokenizer.cpp
+
+HEADERS += \
+    ../CommonData.h \
+    ../Workers/AllocationProfiler.h \
+    ../Workers/Checkpoint.h \
+    ../Workers/DictionarySpill.h \
+    ../Workers/FileReader.h \
+    ../Workers/LetterCombinationsEnumerator.h \
+    ../Workers/PackedLetterCombinationsIndex.h \
+    ../Workers/PipelineMetrics.h \
+    ../Workers/ResultCache.h \
+    ../Workers/ResultIndex.h \
+    ../Workers/ShardedDictionary.h \
+    ../Workers/SpaceSaving.h \
+    ../Workers/StringInterner.h \
+    ../Workers/SuffixAutomaton.h \
+    ../Workers/TextAnalyzer.h \
+    ../Workers/TextEncoding.h \
+    ../Workers/TopKHeap.h \
+    ../Workers/Tracing.h \
+    ../Workers/WordsBatch.h \
+    ../Workers/WordsBatchQueue.h \
+    ../Workers/WordsCombinationsCache.h \
+    ../Workers/WordTokenizer.h
+
+CONFIG(debug, debug|release) {
+    win32: DESTDIR = Debug
+} else {
+    win32: DESTDIR = Release
+}
+
+!isEmpty(DESTDIR) {
+    OBJECTS_DIR = $${DESTDIR}/obj
+    MOC_DIR = $${DESTDIR}/moc
+}
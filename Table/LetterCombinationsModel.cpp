@@ -38,6 +38,10 @@ QVariant CLetterCombinationsModel::data(const QModelIndex& index, int role) cons
         case CommonData::elctcLetterCombination:
             return m_modelData.at(index.row()).first;
         case CommonData::elctcPercentage:
+            if (index.row() < m_errorBounds.size() && m_errorBounds.at(index.row()) > 0) {
+                return QString("%1% %2 %3%").arg(QLocale::system().toString(m_modelData.at(index.row()).second, 'f', 3), QString(QChar(0x00B1)),
+                                                  QLocale::system().toString(m_errorBounds.at(index.row()), 'f', 3));
+            }
             return QString("%1%").arg(QLocale::system().toString(m_modelData.at(index.row()).second, 'f', 3));
         }
 	} else if (role == Qt::TextAlignmentRole) {
@@ -140,13 +144,14 @@ void CLetterCombinationsModel::setColors(const QVector<QColor>& in_colors)
     endResetModel();
 }
 
-void CLetterCombinationsModel::refresh(const QVector<QPair<QString, double>>& in_letterCombinations)
+void CLetterCombinationsModel::refresh(const QVector<QPair<QString, double>>& in_letterCombinations, const QVector<double>& in_errorBounds)
 {
 	beginResetModel();
 
 	m_modelData.clear();
 	m_modelData.shrink_to_fit();
     m_modelData = in_letterCombinations;
+    m_errorBounds = in_errorBounds;
 
 	endResetModel();
 }
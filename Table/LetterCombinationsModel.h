@@ -21,11 +21,13 @@ public:
     bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::DisplayRole) Q_DECL_OVERRIDE;
 
     void setColors(const QVector<QColor>&);
-    void refresh(const QVector<QPair<QString, double>>&);
+    //! Sets letter combinations and their percentages. Error bounds of percentages are shown if they are given and non-zero.
+    void refresh(const QVector<QPair<QString, double>>&, const QVector<double>& in_errorBounds = QVector<double>());
 
 private:
     QVector<QColor> m_colors;
     QVector<QPair<QString, double>> m_modelData;
+    QVector<double> m_errorBounds;
 };
 
 #endif // LETTERCOMBINATIONSMODEL_H
@@ -1,4 +1,6 @@
 #include "TextAnalyzerWindow.h"
+#include "Workers/Tracing.h"
+#include "Workers/AllocationProfiler.h"
 
 #include <QBarSet>
 #include <QLegend>
@@ -11,11 +13,24 @@
 #include <QDesktopWidget>
 #include <QFileInfo>
 #include <QFileDialog>
+#include <QMessageBox>
 #include <QApplication>
 #include <QCoreApplication>
+#include <QtConcurrent>
 
 #include <algorithm>
 
+namespace {
+
+    //! Formats the duration in milliseconds as hours, minutes and seconds.
+    QString formatDuration(qint64 in_duration)
+    {
+        const qint64 seconds = (in_duration + 999) / 1000;
+        return QString("%1:%2:%3").arg(seconds / 3600).arg((seconds / 60) % 60, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0'));
+    }
+
+} // namespace
+
 CTextAnalyzerWindow::CTextAnalyzerWindow(QWidget *parent)
     : QMainWindow(parent)
 {
@@ -30,6 +45,8 @@ CTextAnalyzerWindow::~CTextAnalyzerWindow()
 
 void CTextAnalyzerWindow::updateTopLetterCombinations(const WordsVector& in_topLetterCombinations)
 {
+    const Tracing::CSpan span("TextAnalyzerWindow::updateTopLetterCombinations");
+    const AllocationProfiler::CStageScope stage(AllocationProfiler::esUi);
     auto topLetterCombinations = in_topLetterCombinations;
     std::sort(std::begin(topLetterCombinations), std::end(topLetterCombinations), [](const auto& lhs, const auto& rhs) {
         return lhs.second > rhs.second;
@@ -41,6 +58,7 @@ void CTextAnalyzerWindow::updateTopLetterCombinations(const WordsVector& in_topL
     int barCounter = 0;
     double maxLetterCombinationsPercentage = 0;
     QVector<QPair<QString, double>> vTableData;
+    QVector<double> vTableErrorBounds;
     for (const auto& word : topLetterCombinations) {
         if (barCounter >= barSets.size()) {
             break;
@@ -54,11 +72,21 @@ void CTextAnalyzerWindow::updateTopLetterCombinations(const WordsVector& in_topL
             maxLetterCombinationsPercentage = percentage;
         }
         vTableData.push_back({ word.first, percentage });
+        const quint64 errorBound = m_topLetterCombinationsErrorBounds.value(word.first, 0);
+        vTableErrorBounds.push_back(m_totalLetterCombinationsCount ? (errorBound * 100.0) / m_totalLetterCombinationsCount : 0.0);
         ++barCounter;
     }
     m_maxLetterCombinationsPercentage = maxLetterCombinationsPercentage;
     m_axisY->setRange(0, maxLetterCombinationsPercentage);
-    m_letterCombinationsModel->refresh(vTableData);
+    m_letterCombinationsModel->refresh(vTableData, vTableErrorBounds);
+}
+
+void CTextAnalyzerWindow::updateTopLetterCombinationsErrorBounds(const WordsVector& in_errorBounds)
+{
+    m_topLetterCombinationsErrorBounds.clear();
+    for (const auto& errorBound : in_errorBounds) {
+        m_topLetterCombinationsErrorBounds.insert(errorBound.first, errorBound.second);
+    }
 }
 
 void CTextAnalyzerWindow::updateTotalLetterCombinationsCount(quint64 in_totalLetterCombinationsCount)
@@ -68,9 +96,19 @@ void CTextAnalyzerWindow::updateTotalLetterCombinationsCount(quint64 in_totalLet
 
 void CTextAnalyzerWindow::updateWordsProcessedCount(quint64 in_wordsProcessedCount)
 {
+    const Tracing::CSpan span("TextAnalyzerWindow::updateWordsProcessedCount");
+    const AllocationProfiler::CStageScope stage(AllocationProfiler::esUi);
     m_totalWordsProcessedCountLabel->setText(QLocale::system().toString(in_wordsProcessedCount));
 }
 
+void CTextAnalyzerWindow::updateWordsCombinationsCacheStatistics(quint64 in_hitsCount, quint64 in_missesCount)
+{
+    const quint64 lookupsCount = in_hitsCount + in_missesCount;
+    const double hitRate = lookupsCount ? 100.0 * in_hitsCount / lookupsCount : 0.0;
+    m_totalWordsProcessedCountLabel->setToolTip(QObject::tr("Words cache: %1 hits, %2 misses (%3% hit rate)")
+        .arg(QLocale::system().toString(in_hitsCount), QLocale::system().toString(in_missesCount), QLocale::system().toString(hitRate, 'f', 1)));
+}
+
 void CTextAnalyzerWindow::changeProcessStatus(int in_status)
 {
     if (in_status == CommonData::efrsFileOpenError) {
@@ -78,6 +116,12 @@ void CTextAnalyzerWindow::changeProcessStatus(int in_status)
         m_statusToolButton->setVisible(true);
         m_statusToolButton->setIcon(QIcon(":/Resources/Warning"));
         m_statusLabel->setText(QObject::tr("File not found"));
+    } else if (in_status == CommonData::efrsFileResumeError) {
+        stopTextAnalyzing();
+        m_statusToolButton->setVisible(true);
+        m_statusToolButton->setIcon(QIcon(":/Resources/Warning"));
+        m_statusLabel->setText(QObject::tr("Text analysis can't be resumed"));
+        emit histogramUpdatingFinished();
     } else if (in_status == CommonData::efrsFileProcessingFinished) {
         // Notify the Text Analyzer Worker to finish processing.
         emit fileProcessingFinished();
@@ -91,6 +135,15 @@ void CTextAnalyzerWindow::changeProcessStatus(int in_status)
 
 void CTextAnalyzerWindow::closeEvent(QCloseEvent* event)
 {
+    // The file isn't read yet while its result is looked up in the cache.
+    if (m_resultCacheKeyWatcher.isRunning()) {
+        m_resultCacheKeyWatcher.disconnect(this);
+        m_textAnalyzingStatus = CommonData::ETextAnalyzingStatus::etasIdle;
+    }
+    // Wake up workers waiting for each other.
+    if (m_wordsBatchQueue) {
+        m_wordsBatchQueue->abort();
+    }
     if (m_fileReaderWorkerThread && m_fileReaderWorkerThread->isRunning()) {
         if (m_textAnalyzingStatus == CommonData::ETextAnalyzingStatus::etasTextAnalyzingInProgress && m_fileReaderWorker) {
             m_fileReaderWorker->stopProcessing();
@@ -132,12 +185,147 @@ void CTextAnalyzerWindow::browsePath()
 
 void CTextAnalyzerWindow::finishTextAnalyzing(const WordsVector& in_topWords)
 {
+    const Tracing::CSpan span("TextAnalyzerWindow::finishTextAnalyzing");
+    const AllocationProfiler::CStageScope stage(AllocationProfiler::esUi);
     updateTopLetterCombinations(in_topWords);
     stopTextAnalyzing();
     m_statusToolButton->setVisible(true);
     m_statusToolButton->setIcon(QIcon(":/Resources/Success"));
     m_statusLabel->setText(QObject::tr("Text analysis finished"));
+    if (AllocationProfiler::IsEnabled()) {
+        m_statusLabel->setToolTip(QString("<pre>%1</pre>").arg(AllocationProfiler::Summary().toHtmlEscaped()));
+    }
     emit histogramUpdatingFinished();
+    m_resultCache.evict();
+}
+
+void CTextAnalyzerWindow::processResultCacheKey()
+{
+    const QString filePath = m_filePathLineEdit->text();
+    const QString key = m_resultCacheKeyWatcher.result();
+    CResultIndex resultIndex;
+    if (m_resultCache.find(key, resultIndex)) {
+        updateTotalLetterCombinationsCount(resultIndex.totalLetterCombinationsCount());
+        updateWordsProcessedCount(resultIndex.wordsProcessedCount());
+        finishTextAnalyzing(resultIndex.top(CommonData::TopLetterCombinationsCount));
+        m_statusLabel->setText(QObject::tr("Text analysis finished (cached result)"));
+        return;
+    }
+
+    // The Text Analyzer Worker is set up in its own thread before the file processing starts there. Results are cached by the exact enumerator only,
+    // so a cached result is exact whichever engine is chosen. The result index is written to the cache when text analyzing finishes,
+    // it's named by the key if the file has been hashed, otherwise by the content hash calculated while the file is read.
+    const auto engine = static_cast<CommonData::ELetterCombinationsEngine>(m_engineComboBox->currentData().toInt());
+    const qint64 approximationMemoryBudget = m_approximationMemorySpinBox->value() * 1024LL * 1024;
+    const QString resultIndexFileName = key.isEmpty() ? QString() : m_resultCache.entryFileName(key);
+    if (!key.isEmpty()) {
+        m_resultCacheKeyPrefix.clear();
+    }
+    // The followed file has no end to resume reading from, so it isn't checkpointed.
+    const bool isFollowMode = m_followCheckBox->isChecked();
+    const QString checkpointFileName = isFollowMode ? QString() : CCheckpoint::DefaultFileName(filePath);
+    if (!checkpointFileName.isEmpty() && engine == CommonData::elceEnumerator) {
+        askToResume(filePath, checkpointFileName);
+    }
+    CTextAnalyzerWorker* textAnalyzerWorker = m_textAnalyzerWorker;
+    QMetaObject::invokeMethod(m_textAnalyzerWorker, [=](){
+        textAnalyzerWorker->setEngine(engine);
+        textAnalyzerWorker->setApproximationMemoryBudget(approximationMemoryBudget);
+        textAnalyzerWorker->setResultIndexFileName(resultIndexFileName);
+        textAnalyzerWorker->setCheckpointFileName(checkpointFileName);
+    }, Qt::QueuedConnection);
+    CFileReaderWorker* fileReaderWorker = m_fileReaderWorker;
+    QMetaObject::invokeMethod(m_fileReaderWorker, [=](){
+        fileReaderWorker->setFollowMode(isFollowMode);
+    }, Qt::QueuedConnection);
+
+    // The Text Analyzer Worker resumes the interrupted analysis of the same file and starts the File Reader Worker from the resume offset.
+    emit fileProcessingStarted(filePath);
+}
+
+void CTextAnalyzerWindow::askToResume(const QString& in_filePath, const QString& in_checkpointFileName)
+{
+    CCheckpoint checkpoint;
+    checkpoint.setFileName(in_checkpointFileName);
+    checkpoint.setSourceFileName(in_filePath);
+    qint64 resumeOffset = 0;
+    if (!checkpoint.isAvailable(resumeOffset)) {
+        return;
+    }
+
+    // The Text Analyzer Worker resumes from the checkpoint if it exists, so starting from the beginning removes it.
+    const QLocale locale = QLocale::system();
+    QMessageBox messageBox(QMessageBox::Question, QObject::tr("Resume Text Analysis"),
+                           QObject::tr("Text analysis of this file was interrupted after %1 of %2.")
+                           .arg(locale.formattedDataSize(resumeOffset), locale.formattedDataSize(QFileInfo(in_filePath).size())), QMessageBox::NoButton, this);
+    messageBox.setInformativeText(QObject::tr("Resume it or analyze the file from the beginning?"));
+    QPushButton* resumePushButton = messageBox.addButton(QObject::tr("Resume"), QMessageBox::AcceptRole);
+    messageBox.addButton(QObject::tr("Start Fresh"), QMessageBox::DestructiveRole);
+    messageBox.setDefaultButton(resumePushButton);
+    messageBox.exec();
+    if (messageBox.clickedButton() != resumePushButton) {
+        checkpoint.remove();
+    }
+}
+
+void CTextAnalyzerWindow::updateResultCacheKey(quint64 in_contentHash)
+{
+    if (m_resultCacheKeyPrefix.isEmpty()) {
+        return;
+    }
+
+    // The hash is emitted before the file processing finishes, so the name is set before the Text Analyzer Worker finishes text analyzing.
+    const QString resultIndexFileName = m_resultCache.entryFileName(CResultCache::Key(m_resultCacheKeyPrefix, in_contentHash));
+    m_resultCacheKeyPrefix.clear();
+    CTextAnalyzerWorker* textAnalyzerWorker = m_textAnalyzerWorker;
+    QMetaObject::invokeMethod(m_textAnalyzerWorker, [=](){
+        textAnalyzerWorker->setResultIndexFileName(resultIndexFileName);
+    }, Qt::QueuedConnection);
+}
+
+void CTextAnalyzerWindow::updateMetrics()
+{
+    const Tracing::CSpan span("TextAnalyzerWindow::updateMetrics");
+    const AllocationProfiler::CStageScope stage(AllocationProfiler::esUi);
+    const auto sample = m_pipelineMetrics->sample();
+    const QLocale locale = QLocale::system();
+    m_bytesReadCountLabel->setText(locale.formattedDataSize(sample.bytesRead));
+    m_readingSpeedCountLabel->setText(QObject::tr("%1/s").arg(locale.formattedDataSize(qRound64(sample.bytesPerSecond))));
+    m_analyzingSpeedCountLabel->setText(locale.toString(qRound64(sample.wordsPerSecond)));
+    m_queuedBatchesCountLabel->setText(locale.toString(sample.queuedBatchesCount));
+    m_dictionarySizeCountLabel->setText(locale.toString(sample.dictionarySize));
+    m_cacheHitRateCountLabel->setText(sample.cacheHitRate < 0 ? QObject::tr("n/a") : QString("%1%").arg(locale.toString(100.0 * sample.cacheHitRate, 'f', 1)));
+    m_memoryUsageCountLabel->setText(locale.formattedDataSize(static_cast<qint64>(sample.memoryUsage)));
+    m_remainingTimeCountLabel->setText(sample.remainingTime < 0 ? QObject::tr("n/a") : formatDuration(sample.remainingTime));
+
+    // The progress of an input of unknown size is shown as the busy indicator while text analysis is in progress.
+    if (sample.progress < 0) {
+        const bool isInProgress = m_textAnalyzingStatus == CommonData::ETextAnalyzingStatus::etasTextAnalyzingInProgress;
+        m_progressBar->setRange(0, isInProgress ? 0 : 100);
+        m_progressBar->setValue(isInProgress ? 0 : 100);
+    } else {
+        m_progressBar->setRange(0, 1000);
+        m_progressBar->setValue(qRound(sample.progress * 1000));
+    }
+}
+
+void CTextAnalyzerWindow::setMetricsVisible(bool in_isVisible)
+{
+    m_metricsToolButton->setArrowType(in_isVisible ? Qt::DownArrow : Qt::RightArrow);
+    m_metricsWidget->setVisible(in_isVisible);
+}
+
+void CTextAnalyzerWindow::changeEngine()
+{
+    const bool isApproximate = m_engineComboBox->currentData().toInt() == CommonData::elceSpaceSaving;
+    m_approximationMemoryLabel->setEnabled(isApproximate);
+    m_approximationMemorySpinBox->setEnabled(isApproximate);
+}
+
+void CTextAnalyzerWindow::stopFollowing()
+{
+    m_stopFollowingPushButton->setVisible(false);
+    m_fileReaderWorker->stopProcessing();
 }
 
 void CTextAnalyzerWindow::init()
@@ -149,13 +337,28 @@ void CTextAnalyzerWindow::init()
     setWindowTitle(QObject::tr("Text Analyzer"));
 
     m_fileReaderWorkerThread = new QThread(this);
+    m_fileReaderWorkerThread->setObjectName("File reader");
     m_fileReaderWorker = new CFileReaderWorker();
     m_fileReaderWorker->moveToThread(m_fileReaderWorkerThread);
 
     m_textAnalyzerWorkerThread = new QThread(this);
+    m_textAnalyzerWorkerThread->setObjectName("Text analyzer");
     m_textAnalyzerWorker = new CTextAnalyzerWorker();
     m_textAnalyzerWorker->moveToThread(m_textAnalyzerWorkerThread);
 
+    // Words are passed from the File Reader Worker to the Text Analyzer Worker through the queue of reusable batches.
+    m_wordsBatchQueue.reset(new CWordsBatchQueue());
+    m_fileReaderWorker->setWordsBatchQueue(m_wordsBatchQueue);
+    m_textAnalyzerWorker->setWordsBatchQueue(m_wordsBatchQueue);
+
+    // Workers publish live metrics, which are sampled by the timer while text analysis is in progress.
+    m_pipelineMetrics.reset(new CPipelineMetrics());
+    m_pipelineMetrics->setWordsBatchQueue(m_wordsBatchQueue);
+    m_fileReaderWorker->setPipelineMetrics(m_pipelineMetrics);
+    m_textAnalyzerWorker->setPipelineMetrics(m_pipelineMetrics);
+    m_metricsTimer = new QTimer(this);
+    m_metricsTimer->setInterval(CommonData::MetricsInterval);
+
     createWidgets();
     createMainLayout();
     createConnections();
@@ -235,6 +438,31 @@ void CTextAnalyzerWindow::createWidgets()
 
     m_browseFilePushButton = createActionPushButton(QObject::tr("Browse..."), CommonData::SignificantButtonWithHoverStyleSheet(m_scaleFactor));
 
+    m_engineComboBox = new QComboBox(this);
+    m_engineComboBox->addItem(QObject::tr("Exact"), CommonData::elceEnumerator);
+    m_engineComboBox->addItem(QObject::tr("Exact, top at the end"), CommonData::elceSuffixAutomaton);
+    m_engineComboBox->addItem(QObject::tr("Approximate"), CommonData::elceSpaceSaving);
+    m_engineComboBox->setItemData(0, QObject::tr("Letter combinations are counted exactly, the top is updated while the file is read."), Qt::ToolTipRole);
+    m_engineComboBox->setItemData(1, QObject::tr("Letter combinations are counted exactly by the suffix automaton of distinct words, the top is shown when the file is read."), Qt::ToolTipRole);
+    m_engineComboBox->setItemData(2, QObject::tr("Letter combinations are counted approximately in the given memory, counts are shown with their error bounds."), Qt::ToolTipRole);
+    m_engineComboBox->setFocusPolicy(Qt::NoFocus);
+    m_engineLabel = createTextLabel(QObject::tr("&Counting"), this);
+    m_engineLabel->setBuddy(m_engineComboBox);
+
+    m_approximationMemorySpinBox = new QSpinBox(this);
+    m_approximationMemorySpinBox->setRange(1, 64 * 1024);
+    m_approximationMemorySpinBox->setValue(static_cast<int>(CSpaceSaving::DefaultMemoryBudget / (1024 * 1024)));
+    m_approximationMemorySpinBox->setSuffix(QObject::tr(" MiB"));
+    m_approximationMemoryLabel = createTextLabel(QObject::tr("&Memory"), this);
+    m_approximationMemoryLabel->setBuddy(m_approximationMemorySpinBox);
+    changeEngine();
+
+    m_followCheckBox = new QCheckBox(QObject::tr("F&ollow"), this);
+    m_followCheckBox->setToolTip(QObject::tr("The file is followed like tail -f: appended data is analyzed and the top is updated until following is stopped."));
+    m_followCheckBox->setFocusPolicy(Qt::NoFocus);
+    m_stopFollowingPushButton = createActionPushButton(QObject::tr("Stop"), CommonData::SignificantButtonWithHoverStyleSheet(m_scaleFactor));
+    m_stopFollowingPushButton->setVisible(false);
+
     m_statusInfoWidget = new QWidget(this);
 
     m_statusLabel = createTextLabel("", m_statusInfoWidget);
@@ -248,6 +476,37 @@ void CTextAnalyzerWindow::createWidgets()
 
     m_statusToolButton = createStatusToolButton(m_statusInfoWidget);
     m_textAnalyzingMovieLabel = new QLabel(m_statusInfoWidget);
+
+    // The metrics panel is collapsed by default.
+    m_metricsToolButton = new QToolButton(m_statusInfoWidget);
+    m_metricsToolButton->setText(QObject::tr("Details"));
+    m_metricsToolButton->setToolButtonStyle(Qt::ToolButtonTextBesideIcon);
+    m_metricsToolButton->setArrowType(Qt::RightArrow);
+    m_metricsToolButton->setAutoRaise(true);
+    m_metricsToolButton->setCheckable(true);
+    m_metricsToolButton->setFocusPolicy(Qt::NoFocus);
+
+    m_metricsWidget = new QWidget(m_statusInfoWidget);
+    m_bytesReadLabel = createTextLabel(QObject::tr("Read"), m_metricsWidget);
+    m_bytesReadCountLabel = createCountLabel("", m_metricsWidget);
+    m_readingSpeedLabel = createTextLabel(QObject::tr("Reading speed"), m_metricsWidget);
+    m_readingSpeedCountLabel = createCountLabel("", m_metricsWidget);
+    m_analyzingSpeedLabel = createTextLabel(QObject::tr("Words per second"), m_metricsWidget);
+    m_analyzingSpeedCountLabel = createCountLabel("", m_metricsWidget);
+    m_queuedBatchesLabel = createTextLabel(QObject::tr("Queued batches"), m_metricsWidget);
+    m_queuedBatchesCountLabel = createCountLabel("", m_metricsWidget);
+    m_dictionarySizeLabel = createTextLabel(QObject::tr("Dictionary entries"), m_metricsWidget);
+    m_dictionarySizeCountLabel = createCountLabel("", m_metricsWidget);
+    m_cacheHitRateLabel = createTextLabel(QObject::tr("Cache hit rate"), m_metricsWidget);
+    m_cacheHitRateCountLabel = createCountLabel("", m_metricsWidget);
+    m_memoryUsageLabel = createTextLabel(QObject::tr("Estimated memory"), m_metricsWidget);
+    m_memoryUsageCountLabel = createCountLabel("", m_metricsWidget);
+    m_remainingTimeLabel = createTextLabel(QObject::tr("Remaining time"), m_metricsWidget);
+    m_remainingTimeCountLabel = createCountLabel("", m_metricsWidget);
+    m_progressBar = new QProgressBar(m_metricsWidget);
+    m_progressBar->setRange(0, 1000);
+    m_progressBar->setValue(0);
+    m_metricsWidget->setVisible(false);
     m_statusInfoWidget->setVisible(false);
 
     // Initialize the histogram.
@@ -318,6 +577,12 @@ void CTextAnalyzerWindow::createMainLayout()
     filePathHBoxLayout->addWidget(m_filePathLabel);
     filePathHBoxLayout->addWidget(m_filePathLineEdit);
     filePathHBoxLayout->addWidget(m_browseFilePushButton);
+    filePathHBoxLayout->addWidget(m_engineLabel);
+    filePathHBoxLayout->addWidget(m_engineComboBox);
+    filePathHBoxLayout->addWidget(m_approximationMemoryLabel);
+    filePathHBoxLayout->addWidget(m_approximationMemorySpinBox);
+    filePathHBoxLayout->addWidget(m_followCheckBox);
+    filePathHBoxLayout->addWidget(m_stopFollowingPushButton);
     filePathHBoxLayout->setSpacing(qRound(16 * m_scaleFactor));
 
     auto statusHBoxLayout = new QHBoxLayout;
@@ -328,11 +593,34 @@ void CTextAnalyzerWindow::createMainLayout()
     auto processingMetricsGridLyout = new QGridLayout;
     processingMetricsGridLyout->addWidget(m_totalWordsProcessedLabel, 0, 0, Qt::AlignLeft);
     processingMetricsGridLyout->addWidget(m_totalWordsProcessedCountLabel, 0, 1, Qt::AlignRight);
+    processingMetricsGridLyout->addWidget(m_metricsToolButton, 0, 2, Qt::AlignLeft);
+
+    // Live metrics are placed in pairs of columns: a name and a value.
+    const QVector<QPair<QLabel*, QLabel*>> liveMetricsLabels {
+        { m_bytesReadLabel, m_bytesReadCountLabel },
+        { m_readingSpeedLabel, m_readingSpeedCountLabel },
+        { m_analyzingSpeedLabel, m_analyzingSpeedCountLabel },
+        { m_queuedBatchesLabel, m_queuedBatchesCountLabel },
+        { m_dictionarySizeLabel, m_dictionarySizeCountLabel },
+        { m_cacheHitRateLabel, m_cacheHitRateCountLabel },
+        { m_memoryUsageLabel, m_memoryUsageCountLabel },
+        { m_remainingTimeLabel, m_remainingTimeCountLabel }
+    };
+    constexpr int liveMetricsPerRow = 4;
+    auto liveMetricsGridLayout = new QGridLayout;
+    for (int i = 0; i < liveMetricsLabels.size(); ++i) {
+        liveMetricsGridLayout->addWidget(liveMetricsLabels[i].first, i / liveMetricsPerRow, 2 * (i % liveMetricsPerRow), Qt::AlignLeft);
+        liveMetricsGridLayout->addWidget(liveMetricsLabels[i].second, i / liveMetricsPerRow, 2 * (i % liveMetricsPerRow) + 1, Qt::AlignRight);
+    }
+    liveMetricsGridLayout->addWidget(m_progressBar, liveMetricsLabels.size() / liveMetricsPerRow, 0, 1, 2 * liveMetricsPerRow);
+    liveMetricsGridLayout->setContentsMargins(0, 0, 0, 0);
+    m_metricsWidget->setLayout(liveMetricsGridLayout);
 
     auto statusInfoGridLayout = new QGridLayout;
     statusInfoGridLayout->addLayout(statusHBoxLayout, 0, 0, Qt::AlignRight);
     statusInfoGridLayout->addWidget(m_statusVerticalLine, 0, 1);
     statusInfoGridLayout->addLayout(processingMetricsGridLyout, 0, 2, Qt::AlignLeft);
+    statusInfoGridLayout->addWidget(m_metricsWidget, 1, 0, 1, 3);
     m_statusInfoWidget->setLayout(statusInfoGridLayout);
 
     auto dataRepresentationHBoxLayout = new QHBoxLayout;
@@ -351,15 +639,24 @@ void CTextAnalyzerWindow::createConnections()
 {
     QObject::connect(m_fileReaderWorkerThread, &QThread::finished, m_fileReaderWorker, &CFileReaderWorker::deleteLater);
     QObject::connect(m_fileReaderWorkerThread, &QThread::finished, m_fileReaderWorkerThread, &QThread::deleteLater);
-    QObject::connect(this, &CTextAnalyzerWindow::fileProcessingStarted, m_fileReaderWorker, &CFileReaderWorker::process);
+    QObject::connect(m_fileReaderWorker, &CFileReaderWorker::contentHashCalculated, this, &CTextAnalyzerWindow::updateResultCacheKey);
     QObject::connect(m_fileReaderWorker, &CFileReaderWorker::statusChanged, this, &CTextAnalyzerWindow::changeProcessStatus);
 
     QObject::connect(m_textAnalyzerWorkerThread, &QThread::finished, m_textAnalyzerWorker, &CTextAnalyzerWorker::deleteLater);
     QObject::connect(m_textAnalyzerWorkerThread, &QThread::finished, m_textAnalyzerWorkerThread, &QThread::deleteLater);
-    QObject::connect(m_fileReaderWorker, &CFileReaderWorker::chunkProcessed, m_textAnalyzerWorker, &CTextAnalyzerWorker::process);
+    // The state is restored before words batches are taken, the file is read from the offset of the restored state.
+    QObject::connect(this, &CTextAnalyzerWindow::fileProcessingStarted, m_textAnalyzerWorker, &CTextAnalyzerWorker::resume);
+    QObject::connect(this, &CTextAnalyzerWindow::fileProcessingStarted, m_textAnalyzerWorker, &CTextAnalyzerWorker::processQueue);
+    QObject::connect(m_textAnalyzerWorker, &CTextAnalyzerWorker::resumed, m_fileReaderWorker, &CFileReaderWorker::processFrom);
+    // Following can be stopped once the file reader is started, a stop request is queued after the start then.
+    QObject::connect(m_textAnalyzerWorker, &CTextAnalyzerWorker::resumed, this, [this](){
+        m_stopFollowingPushButton->setVisible(m_followCheckBox->isChecked() && m_textAnalyzingStatus == CommonData::ETextAnalyzingStatus::etasTextAnalyzingInProgress);
+    });
     QObject::connect(m_textAnalyzerWorker, &CTextAnalyzerWorker::topLetterCombinationsUpdated, this, &CTextAnalyzerWindow::updateTopLetterCombinations);
+    QObject::connect(m_textAnalyzerWorker, &CTextAnalyzerWorker::topLetterCombinationsErrorBoundsUpdated, this, &CTextAnalyzerWindow::updateTopLetterCombinationsErrorBounds);
     QObject::connect(m_textAnalyzerWorker, &CTextAnalyzerWorker::totalLetterCombinationsCountUpdated, this, &CTextAnalyzerWindow::updateTotalLetterCombinationsCount);
     QObject::connect(m_textAnalyzerWorker, &CTextAnalyzerWorker::wordsProcessedCountUpdated, this, &CTextAnalyzerWindow::updateWordsProcessedCount);
+    QObject::connect(m_textAnalyzerWorker, &CTextAnalyzerWorker::wordsCombinationsCacheStatisticsUpdated, this, &CTextAnalyzerWindow::updateWordsCombinationsCacheStatistics);
     // Inform text analyzer to finish text processing.
     QObject::connect(this, &CTextAnalyzerWindow::fileProcessingFinished, m_textAnalyzerWorker, &CTextAnalyzerWorker::finishTextAnalyzing);
     // When text analyzer has processed rest data, update UI.
@@ -368,6 +665,11 @@ void CTextAnalyzerWindow::createConnections()
     QObject::connect(this, &CTextAnalyzerWindow::histogramUpdatingFinished, m_textAnalyzerWorker, &CTextAnalyzerWorker::finishProcessing);
 
     QObject::connect(m_browseFilePushButton, &CGlowedButton::clicked, this, &CTextAnalyzerWindow::browsePath);
+    QObject::connect(m_stopFollowingPushButton, &CGlowedButton::clicked, this, &CTextAnalyzerWindow::stopFollowing);
+    QObject::connect(&m_resultCacheKeyWatcher, &QFutureWatcher<QString>::finished, this, &CTextAnalyzerWindow::processResultCacheKey);
+    QObject::connect(m_metricsTimer, &QTimer::timeout, this, &CTextAnalyzerWindow::updateMetrics);
+    QObject::connect(m_metricsToolButton, &QToolButton::toggled, this, &CTextAnalyzerWindow::setMetricsVisible);
+    QObject::connect(m_engineComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &CTextAnalyzerWindow::changeEngine);
 }
 
 void CTextAnalyzerWindow::createTextAnalyzingMovie()
@@ -391,12 +693,17 @@ void CTextAnalyzerWindow::startTextAnalyzing()
 {
     createTextAnalyzingMovie();
     m_browseFilePushButton->setDisabled(true);
+    m_engineComboBox->setDisabled(true);
+    m_approximationMemorySpinBox->setDisabled(true);
+    m_followCheckBox->setDisabled(true);
     m_statusInfoWidget->setVisible(true);
     m_textAnalyzingMovieLabel->setVisible(true);
     m_statusToolButton->setVisible(false);
     m_totalWordsProcessedCountLabel->setText(QString("%1").arg(0));
+    m_totalWordsProcessedCountLabel->setToolTip(QString());
     m_axisY->setRange(0, 1.0);
     m_maxLetterCombinationsPercentage = 0.0;
+    m_topLetterCombinationsErrorBounds.clear();
     auto barSets = m_barSeries->barSets();
     for (auto& barSet : barSets) {
         if (barSet) {
@@ -405,9 +712,23 @@ void CTextAnalyzerWindow::startTextAnalyzing()
         }
     }
     m_statusLabel->setText(m_textAnalyzingInProgressText);
+    m_statusLabel->setToolTip(QString());
     m_textAnalyzingStatus = CommonData::ETextAnalyzingStatus::etasTextAnalyzingInProgress;
     m_textAnalyzingMovie->start();
-    emit fileProcessingStarted(m_filePathLineEdit->text());
+    m_pipelineMetrics->reset();
+    updateMetrics();
+    m_metricsTimer->start();
+
+    // The file is hashed in the background to look up the result of its previous analysis only if there is an entry of a file
+    // with the same size and modification time. Otherwise the key is completed by the content hash calculated while the file is read.
+    // The followed file keeps growing, so its result isn't cached.
+    const QString filePath = m_filePathLineEdit->text();
+    const CResultCache resultCache = m_resultCache;
+    const bool isFollowMode = m_followCheckBox->isChecked();
+    m_resultCacheKeyPrefix = isFollowMode ? QString() : CResultCache::KeyPrefix(filePath);
+    m_resultCacheKeyWatcher.setFuture(QtConcurrent::run([filePath, resultCache, isFollowMode](){
+        return !isFollowMode && resultCache.containsKeyPrefix(CResultCache::KeyPrefix(filePath)) ? CResultCache::Key(filePath) : QString();
+    }));
 }
 
 void CTextAnalyzerWindow::stopTextAnalyzing()
@@ -418,8 +739,14 @@ void CTextAnalyzerWindow::stopTextAnalyzing()
     breakTextAnalyzingMovie();
     m_textAnalyzingMovieLabel->setVisible(false);
     m_browseFilePushButton->setEnabled(true);
+    m_engineComboBox->setEnabled(true);
+    changeEngine();
+    m_followCheckBox->setEnabled(true);
+    m_stopFollowingPushButton->setVisible(false);
     m_totalLetterCombinationsCount = 0;
     m_textAnalyzingStatus = CommonData::ETextAnalyzingStatus::etasIdle;
+    m_metricsTimer->stop();
+    updateMetrics();
 }
 
 void CTextAnalyzerWindow::dropUIState()
@@ -428,6 +755,7 @@ void CTextAnalyzerWindow::dropUIState()
     m_statusInfoWidget->setVisible(false);
     m_filePathLineEdit->clear();
     m_totalWordsProcessedCountLabel->setText(QString("%1").arg(0));
+    m_totalWordsProcessedCountLabel->setToolTip(QString());
     m_axisY->setRange(0, 1.0);
     m_maxLetterCombinationsPercentage = 0.0;
     auto barSets = m_barSeries->barSets();
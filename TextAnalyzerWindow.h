@@ -4,6 +4,8 @@
 #include "CommonData.h"
 #include "Workers/FileReader.h"
 #include "Workers/TextAnalyzer.h"
+#include "Workers/ResultCache.h"
+#include "Workers/PipelineMetrics.h"
 #include "Widgets/GlowedButton.h"
 #include "Table/LetterCombinationsModel.h"
 #include "Table/LetterCombinationsTableView.h"
@@ -13,13 +15,20 @@
 #include <QMovie>
 #include <QFrame>
 #include <QLineEdit>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QSpinBox>
 #include <QPushButton>
 #include <QToolButton>
+#include <QProgressBar>
+#include <QTimer>
 #include <QChartView>
 #include <QBarSeries>
 #include <QBarCategoryAxis>
 #include <QValueAxis>
 #include <QVBoxLayout>
+#include <QHash>
+#include <QFutureWatcher>
 
 QT_CHARTS_USE_NAMESPACE
 
@@ -33,9 +42,15 @@ public:
 
 public slots:
     void updateTopLetterCombinations(const WordsVector&);
+
+    //! Error bounds of the top letter combinations' counts. They are received before the top letter combinations in the approximate mode only.
+    void updateTopLetterCombinationsErrorBounds(const WordsVector&);
     void updateWordsProcessedCount(quint64);
     void updateTotalLetterCombinationsCount(quint64);
 
+    //! Shows hits and misses of the cache of words' letter combinations in the tooltip of the processed words count.
+    void updateWordsCombinationsCacheStatistics(quint64 in_hitsCount, quint64 in_missesCount);
+
     //! Status from the CommonData::EFileReadingStatus enumeration.
     void changeProcessStatus(int);
 
@@ -51,6 +66,24 @@ private slots:
     void browsePath();
     void finishTextAnalyzing(const WordsVector&);
 
+    //! Shows the cached result of the file if its key is found in the result cache, otherwise starts workers.
+    void processResultCacheKey();
+
+    //! Names the result index of the analyzed file by its content hash calculated by the File Reader Worker.
+    void updateResultCacheKey(quint64 in_contentHash);
+
+    //! Shows the sample of live metrics in the metrics panel.
+    void updateMetrics();
+
+    //! Expands or collapses the metrics panel.
+    void setMetricsVisible(bool in_isVisible);
+
+    //! Enables the memory budget of the approximate engine if it's selected.
+    void changeEngine();
+
+    //! Stops following of the file. The read data is analyzed to the end and the final top is shown.
+    void stopFollowing();
+
 private:
     void init();
 
@@ -64,6 +97,10 @@ private:
     void startTextAnalyzing();
     void stopTextAnalyzing();
 
+    //! Asks the user whether to resume the interrupted analysis of the file from its checkpoint. The checkpoint is removed
+    //! if the user starts from the beginning.
+    void askToResume(const QString& in_filePath, const QString& in_checkpointFileName);
+
     void dropUIState();
 
     QWidget* m_mainWidget { nullptr };
@@ -71,10 +108,22 @@ private:
     QThread* m_fileReaderWorkerThread { nullptr };
     CTextAnalyzerWorker* m_textAnalyzerWorker { nullptr };
     QThread* m_textAnalyzerWorkerThread { nullptr };
+    QSharedPointer<CWordsBatchQueue> m_wordsBatchQueue;
+    CResultCache m_resultCache;
+    QFutureWatcher<QString> m_resultCacheKeyWatcher;  //!< Watches the key of the analyzed file, which is calculated in the background.
+    QString m_resultCacheKeyPrefix;                     //!< The key prefix of the analyzed file, empty if the file isn't cached.
+    QSharedPointer<CPipelineMetrics> m_pipelineMetrics;
+    QTimer* m_metricsTimer { nullptr };                 //!< Samples live metrics while text analysis is in progress.
 
     QLabel* m_filePathLabel { nullptr };
     QLineEdit* m_filePathLineEdit { nullptr };
     CGlowedButton* m_browseFilePushButton { nullptr };
+    QLabel* m_engineLabel { nullptr };
+    QComboBox* m_engineComboBox { nullptr };            //!< Letter combinations engines, the item's data is CommonData::ELetterCombinationsEngine.
+    QLabel* m_approximationMemoryLabel { nullptr };
+    QSpinBox* m_approximationMemorySpinBox { nullptr };  //!< The memory budget of the approximate engine in megabytes.
+    QCheckBox* m_followCheckBox { nullptr };            //!< Follows the growing file like tail -f.
+    CGlowedButton* m_stopFollowingPushButton { nullptr };
     QScopedPointer<QMovie> m_textAnalyzingMovie { nullptr };
     QLabel* m_textAnalyzingMovieLabel { nullptr };
     QToolButton* m_statusToolButton { nullptr };
@@ -83,6 +132,25 @@ private:
     QLabel* m_totalWordsProcessedCountLabel { nullptr };
     QFrame* m_statusVerticalLine { nullptr };
     QWidget* m_statusInfoWidget { nullptr };
+    QToolButton* m_metricsToolButton { nullptr };
+    QWidget* m_metricsWidget { nullptr };
+    QLabel* m_bytesReadLabel { nullptr };
+    QLabel* m_bytesReadCountLabel { nullptr };
+    QLabel* m_readingSpeedLabel { nullptr };
+    QLabel* m_readingSpeedCountLabel { nullptr };
+    QLabel* m_analyzingSpeedLabel { nullptr };
+    QLabel* m_analyzingSpeedCountLabel { nullptr };
+    QLabel* m_queuedBatchesLabel { nullptr };
+    QLabel* m_queuedBatchesCountLabel { nullptr };
+    QLabel* m_dictionarySizeLabel { nullptr };
+    QLabel* m_dictionarySizeCountLabel { nullptr };
+    QLabel* m_cacheHitRateLabel { nullptr };
+    QLabel* m_cacheHitRateCountLabel { nullptr };
+    QLabel* m_memoryUsageLabel { nullptr };
+    QLabel* m_memoryUsageCountLabel { nullptr };
+    QLabel* m_remainingTimeLabel { nullptr };
+    QLabel* m_remainingTimeCountLabel { nullptr };
+    QProgressBar* m_progressBar { nullptr };
 
     QChart* m_histogram { nullptr };
     QChartView* m_histogramView { nullptr };
@@ -95,9 +163,10 @@ private:
 
     QVBoxLayout* m_mainLayout { nullptr };
 
-    QString m_defaultPath { ".\\..\\..\\..\\TextAnalyzer\\Data" };
+    QString m_defaultPath { ".\\..\\..\\..\\..\\TextAnalyzer\\Data" };
     QString m_textAnalyzingInProgressText { QObject::tr("Text analysis") };
     quint64 m_totalLetterCombinationsCount { 0 };
+    QHash<QString, quint64> m_topLetterCombinationsErrorBounds;
     double m_maxLetterCombinationsPercentage { 0.0 };
     double m_scaleFactor { 1.0 };
 
@@ -0,0 +1,151 @@
+// The allocation hooks of AllocationProfiler. The file is compiled into programs including Core/AllocationProfiling.pri only,
+// so regular builds of the GUI application and the command line tool keep the C allocator.
+#include "AllocationProfiler.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+    const bool isInstalled = (AllocationProfiler::Hooks::SetInstalled(), true);
+
+} // namespace
+
+#ifdef __GLIBC__
+
+// The executable's definitions take precedence over the C library's ones in all loaded libraries, the operator new calls them too.
+extern "C" {
+
+void* __libc_malloc(std::size_t);
+void* __libc_calloc(std::size_t, std::size_t);
+void* __libc_realloc(void*, std::size_t);
+void* __libc_memalign(std::size_t, std::size_t);
+void* __libc_valloc(std::size_t);
+void* __libc_pvalloc(std::size_t);
+void __libc_free(void*);
+
+void* malloc(std::size_t in_size)
+{
+    void* pointer = __libc_malloc(in_size);
+    if (pointer) {
+        AllocationProfiler::Hooks::AccountAllocation(in_size, pointer);
+    }
+    return pointer;
+}
+
+void* calloc(std::size_t in_count, std::size_t in_size)
+{
+    void* pointer = __libc_calloc(in_count, in_size);
+    if (pointer) {
+        AllocationProfiler::Hooks::AccountAllocation(in_count * in_size, pointer);
+    }
+    return pointer;
+}
+
+void* realloc(void* in_pointer, std::size_t in_size)
+{
+    const std::size_t previousBlockSize = in_pointer ? AllocationProfiler::Hooks::BlockSize(in_pointer) : 0;
+    void* pointer = __libc_realloc(in_pointer, in_size);
+
+    // The previous block is kept if reallocation fails.
+    if (pointer || !in_size) {
+        AllocationProfiler::Hooks::AccountFreedBlock(previousBlockSize);
+        if (pointer) {
+            AllocationProfiler::Hooks::AccountAllocation(in_size, pointer);
+        }
+    }
+    return pointer;
+}
+
+void* memalign(std::size_t in_alignment, std::size_t in_size)
+{
+    void* pointer = __libc_memalign(in_alignment, in_size);
+    if (pointer) {
+        AllocationProfiler::Hooks::AccountAllocation(in_size, pointer);
+    }
+    return pointer;
+}
+
+void* aligned_alloc(std::size_t in_alignment, std::size_t in_size)
+{
+    return memalign(in_alignment, in_size);
+}
+
+int posix_memalign(void** out_pointer, std::size_t in_alignment, std::size_t in_size)
+{
+    if (!in_alignment || in_alignment % sizeof(void*) || (in_alignment & (in_alignment - 1))) {
+        return EINVAL;
+    }
+    void* pointer = memalign(in_alignment, in_size);
+    if (!pointer) {
+        return ENOMEM;
+    }
+    *out_pointer = pointer;
+    return 0;
+}
+
+void* valloc(std::size_t in_size)
+{
+    void* pointer = __libc_valloc(in_size);
+    if (pointer) {
+        AllocationProfiler::Hooks::AccountAllocation(in_size, pointer);
+    }
+    return pointer;
+}
+
+void* pvalloc(std::size_t in_size)
+{
+    void* pointer = __libc_pvalloc(in_size);
+    if (pointer) {
+        AllocationProfiler::Hooks::AccountAllocation(in_size, pointer);
+    }
+    return pointer;
+}
+
+void free(void* in_pointer)
+{
+    AllocationProfiler::Hooks::AccountFree(in_pointer);
+    __libc_free(in_pointer);
+}
+
+} // extern "C"
+
+#else
+
+void* operator new(std::size_t in_size)
+{
+    if (void* pointer = std::malloc(in_size ? in_size : 1)) {
+        AllocationProfiler::Hooks::AccountAllocation(in_size, pointer);
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t in_size)
+{
+    return operator new(in_size);
+}
+
+void operator delete(void* in_pointer) noexcept
+{
+    AllocationProfiler::Hooks::AccountFree(in_pointer);
+    std::free(in_pointer);
+}
+
+void operator delete[](void* in_pointer) noexcept
+{
+    operator delete(in_pointer);
+}
+
+void operator delete(void* in_pointer, std::size_t) noexcept
+{
+    operator delete(in_pointer);
+}
+
+void operator delete[](void* in_pointer, std::size_t) noexcept
+{
+    operator delete(in_pointer);
+}
+
+#endif // __GLIBC__
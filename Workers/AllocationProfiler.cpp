@@ -0,0 +1,168 @@
+#include "AllocationProfiler.h"
+
+#if defined(__GLIBC__) || defined(Q_OS_WIN)
+#include <malloc.h>
+#elif defined(Q_OS_MACOS)
+#include <malloc/malloc.h>
+#endif
+
+namespace {
+
+    struct SStageCounters
+    {
+        std::atomic<quint64> allocationsCount { 0 };
+        std::atomic<quint64> allocatedBytes { 0 };
+        std::atomic<qint64> liveBytes { 0 };
+        std::atomic<qint64> peakLiveBytes { 0 };
+    };
+
+    SStageCounters stagesCounters[AllocationProfiler::esStagesCount];
+
+    // The hooks are linked statically, so the thread-local variable is accessed without allocations, which would recurse into the hooks.
+    thread_local int currentStage = AllocationProfiler::esOther;
+
+    std::atomic<bool> isInstalled { false };
+    std::atomic<qint64> processLiveBytes { 0 };
+    std::atomic<qint64> processPeakLiveBytes { 0 };
+
+    void updatePeak(std::atomic<qint64>& inout_peakLiveBytes, qint64 in_liveBytes)
+    {
+        qint64 peakLiveBytes = inout_peakLiveBytes.load(std::memory_order_relaxed);
+        while (in_liveBytes > peakLiveBytes && !inout_peakLiveBytes.compare_exchange_weak(peakLiveBytes, in_liveBytes, std::memory_order_relaxed)) {}
+    }
+
+} // namespace
+
+namespace AllocationProfiler {
+
+    bool IsAvailable()
+    {
+        return isInstalled.load(std::memory_order_relaxed);
+    }
+
+    void SetEnabled(bool in_isEnabled)
+    {
+        IsEnabledFlag.store(in_isEnabled, std::memory_order_relaxed);
+    }
+
+    void Reset()
+    {
+        for (auto& counters : stagesCounters) {
+            counters.allocationsCount.store(0, std::memory_order_relaxed);
+            counters.allocatedBytes.store(0, std::memory_order_relaxed);
+            counters.liveBytes.store(0, std::memory_order_relaxed);
+            counters.peakLiveBytes.store(0, std::memory_order_relaxed);
+        }
+        processPeakLiveBytes.store(processLiveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    SSnapshot Snapshot()
+    {
+        SSnapshot snapshot;
+        for (const auto& counters : stagesCounters) {
+            snapshot.allocationsCount += counters.allocationsCount.load(std::memory_order_relaxed);
+            snapshot.allocatedBytes += counters.allocatedBytes.load(std::memory_order_relaxed);
+        }
+        snapshot.liveBytes = processLiveBytes.load(std::memory_order_relaxed);
+        snapshot.peakLiveBytes = processPeakLiveBytes.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    SStageStatistics StageStatistics(EStage in_stage)
+    {
+        const SStageCounters& counters = stagesCounters[in_stage];
+        return { counters.allocationsCount.load(std::memory_order_relaxed), counters.allocatedBytes.load(std::memory_order_relaxed),
+                 counters.peakLiveBytes.load(std::memory_order_relaxed) };
+    }
+
+    QString StageName(EStage in_stage)
+    {
+        switch (in_stage) {
+        case esOther: return "other";
+        case esReader: return "reader";
+        case esTokenizer: return "tokenizer";
+        case esEnumerator: return "enumerator";
+        case esDictionaryInsert: return "dictionary insert";
+        case esTopK: return "top-K";
+        case esUi: return "UI";
+        default: return QString();
+        }
+    }
+
+    QString Summary()
+    {
+        QString summary = QString("%1 %2 %3 %4\n").arg("stage", -18).arg("allocations", 14).arg("bytes", 16).arg("peak live bytes", 16);
+        for (int stage = 0; stage < esStagesCount; ++stage) {
+            const auto statistics = StageStatistics(static_cast<EStage>(stage));
+            summary += QString("%1 %2 %3 %4\n").arg(StageName(static_cast<EStage>(stage)), -18).arg(statistics.allocationsCount, 14)
+                       .arg(statistics.allocatedBytes, 16).arg(statistics.peakLiveBytes, 16);
+        }
+        return summary;
+    }
+
+    namespace Hooks {
+
+        void SetInstalled()
+        {
+            isInstalled.store(true, std::memory_order_relaxed);
+        }
+
+        std::size_t BlockSize(void* in_pointer)
+        {
+#if defined(__GLIBC__)
+            return malloc_usable_size(in_pointer);
+#elif defined(Q_OS_WIN)
+            return _msize(in_pointer);
+#elif defined(Q_OS_MACOS)
+            return malloc_size(in_pointer);
+#else
+            Q_UNUSED(in_pointer);
+            return 0;
+#endif
+        }
+
+        void AccountAllocation(std::size_t in_size, void* in_pointer)
+        {
+            const qint64 size = static_cast<qint64>(BlockSize(in_pointer));
+            updatePeak(processPeakLiveBytes, processLiveBytes.fetch_add(size, std::memory_order_relaxed) + size);
+            if (!IsEnabled()) {
+                return;
+            }
+
+            SStageCounters& counters = stagesCounters[currentStage];
+            counters.allocationsCount.fetch_add(1, std::memory_order_relaxed);
+            counters.allocatedBytes.fetch_add(in_size, std::memory_order_relaxed);
+            updatePeak(counters.peakLiveBytes, counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size);
+        }
+
+        void AccountFree(void* in_pointer)
+        {
+            if (in_pointer) {
+                AccountFreedBlock(BlockSize(in_pointer));
+            }
+        }
+
+        void AccountFreedBlock(std::size_t in_blockSize)
+        {
+            const qint64 size = static_cast<qint64>(in_blockSize);
+            processLiveBytes.fetch_sub(size, std::memory_order_relaxed);
+            if (IsEnabled()) {
+                stagesCounters[currentStage].liveBytes.fetch_sub(size, std::memory_order_relaxed);
+            }
+        }
+
+    } // namespace Hooks
+
+    EStage CurrentStage()
+    {
+        return static_cast<EStage>(currentStage);
+    }
+
+    EStage SetCurrentStage(EStage in_stage)
+    {
+        const auto previousStage = static_cast<EStage>(currentStage);
+        currentStage = in_stage;
+        return previousStage;
+    }
+
+} // namespace AllocationProfiler
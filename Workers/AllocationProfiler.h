@@ -0,0 +1,123 @@
+#ifndef ALLOCATIONPROFILER_H
+#define ALLOCATIONPROFILER_H
+
+#include <QtGlobal>
+#include <QString>
+
+#include <atomic>
+#include <cstddef>
+
+//! Accounting of heap allocations by stages of the pipeline. Stages are marked by scopes in the code, the innermost scope of the thread
+//! is the active stage, which allocations and frees are attributed to. Allocations are seen by the hooks in AllocationHooks.cpp, which
+//! are linked only into programs including Core/AllocationProfiling.pri: the benchmarks, and the GUI application and the command line tool
+//! built with CONFIG+=allocation_profiling. Other builds keep the C allocator, nothing is accounted there.
+//! With glibc malloc() and its whole family are interposed, so allocations of Qt containers are counted as well as the ones
+//! of the operator new. Elsewhere only the global operator new is replaced, Qt containers aren't counted.
+//! Accounting is disabled by default, the hooks keep only the process' live heap bytes then.
+namespace AllocationProfiler {
+
+    enum EStage
+    {
+        esOther = 0,
+        esReader,               //!< Reading of the file and passing of words batches.
+        esTokenizer,            //!< Splitting of text to words and counting of words in batches.
+        esEnumerator,           //!< Enumeration of words' letter combinations.
+        esDictionaryInsert,     //!< Counting of letter combinations in the engine's dictionary.
+        esTopK,                 //!< Rebuilding of the most common letter combinations.
+        esUi,                   //!< Updating of the window.
+        esStagesCount
+    };
+
+    //! Allocations attributed to a stage. Live bytes are allocated minus freed bytes while the stage is active,
+    //! so memory freed by another stage, e.g. a words batch, lowers the live bytes of that stage.
+    struct SStageStatistics
+    {
+        quint64 allocationsCount { 0 };
+        quint64 allocatedBytes { 0 };
+        qint64 peakLiveBytes { 0 };
+    };
+
+    //! Allocations of all stages. Live bytes of the process are accounted since its start whether accounting is enabled or not,
+    //! so blocks allocated before enabling are freed exactly.
+    struct SSnapshot
+    {
+        quint64 allocationsCount { 0 };
+        quint64 allocatedBytes { 0 };
+        qint64 liveBytes { 0 };
+        qint64 peakLiveBytes { 0 };     //!< The peak since the start or the last reset.
+    };
+
+    inline std::atomic<bool> IsEnabledFlag { false };
+
+    inline bool IsEnabled() { return IsEnabledFlag.load(std::memory_order_relaxed); }
+
+    //! Checks if the allocation hooks are linked into the program.
+    bool IsAvailable();
+
+    //! Enables or disables accounting. Accounted allocations are kept.
+    void SetEnabled(bool in_isEnabled);
+
+    //! Clears accounted allocations of all stages. The peak live bytes of the process restart from its live bytes.
+    void Reset();
+
+    SSnapshot Snapshot();
+    SStageStatistics StageStatistics(EStage in_stage);
+    QString StageName(EStage in_stage);
+
+    //! Returns the table of stages' allocations for the run summary.
+    QString Summary();
+
+    //! Makes the stage active in the calling thread during the scope.
+    class CStageScope
+    {
+    public:
+        explicit CStageScope(EStage in_stage);
+        ~CStageScope();
+
+        CStageScope(const CStageScope&) = delete;
+        CStageScope& operator=(const CStageScope&) = delete;
+
+    private:
+        int m_previousStage { -1 };     //!< The stage to restore, -1 if accounting has been disabled.
+    };
+
+    //! Entry points of the allocation hooks.
+    namespace Hooks {
+
+        void SetInstalled();
+
+        //! Returns the size of the heap block. Zero means the size is unknown and live bytes aren't accounted.
+        std::size_t BlockSize(void* in_pointer);
+
+        void AccountAllocation(std::size_t in_size, void* in_pointer);
+        void AccountFree(void* in_pointer);
+
+        //! Accounts the free of the block of the given size, e.g. the previous block of realloc(), which is gone before the call returns.
+        void AccountFreedBlock(std::size_t in_blockSize);
+
+    } // namespace Hooks
+
+    //! Returns the active stage of the calling thread.
+    EStage CurrentStage();
+
+    //! Sets the active stage of the calling thread.
+    //! @return the previous stage.
+    EStage SetCurrentStage(EStage in_stage);
+
+    inline CStageScope::CStageScope(EStage in_stage)
+    {
+        if (IsEnabled()) {
+            m_previousStage = SetCurrentStage(in_stage);
+        }
+    }
+
+    inline CStageScope::~CStageScope()
+    {
+        if (m_previousStage >= 0) {
+            SetCurrentStage(static_cast<EStage>(m_previousStage));
+        }
+    }
+
+} // namespace AllocationProfiler
+
+#endif // ALLOCATIONPROFILER_H
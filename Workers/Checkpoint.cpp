@@ -0,0 +1,118 @@
+#include "Checkpoint.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+namespace {
+
+    constexpr quint32 Magic = 0x54414350;   // "TACP"
+    constexpr quint32 Version = 1;
+
+} // namespace
+
+QString CCheckpoint::DefaultFileName(const QString& in_sourceFileName)
+{
+    const QByteArray pathHash = QCryptographicHash::hash(QFileInfo(in_sourceFileName).absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+    return QDir(QDir::tempPath()).filePath(QString("TextAnalyzer-%1.checkpoint").arg(QString::fromLatin1(pathHash.left(16))));
+}
+
+void CCheckpoint::setFileName(const QString& in_fileName)
+{
+    m_fileName = in_fileName;
+}
+
+void CCheckpoint::setSourceFileName(const QString& in_sourceFileName)
+{
+    const QFileInfo sourceFileInfo(in_sourceFileName);
+    m_sourceFileName = sourceFileInfo.absoluteFilePath();
+    m_sourceSize = sourceFileInfo.exists() ? sourceFileInfo.size() : -1;
+    m_sourceLastModified = sourceFileInfo.exists() ? sourceFileInfo.lastModified().toMSecsSinceEpoch() : -1;
+}
+
+bool CCheckpoint::write(qint64 in_resumeOffset, const std::function<void(QDataStream&)>& in_writeState) const
+{
+    if (!isEnabled()) {
+        return false;
+    }
+
+    // The file replaces the previous checkpoint only when it's completely written.
+    QSaveFile file(m_fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << Magic << Version << m_sourceFileName << m_sourceSize << m_sourceLastModified << in_resumeOffset;
+    in_writeState(stream);
+    if (stream.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+bool CCheckpoint::read(qint64& out_resumeOffset, const std::function<bool(QDataStream&)>& in_readState) const
+{
+    if (!isEnabled() || m_sourceSize < 0) {
+        return false;
+    }
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+    qint64 resumeOffset = -1;
+    if (!readHeader(stream, resumeOffset) || !in_readState(stream) || stream.status() != QDataStream::Ok) {
+        return false;
+    }
+    out_resumeOffset = resumeOffset;
+    return true;
+}
+
+bool CCheckpoint::isAvailable(qint64& out_resumeOffset) const
+{
+    if (!isEnabled() || m_sourceSize < 0) {
+        return false;
+    }
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+    return readHeader(stream, out_resumeOffset);
+}
+
+bool CCheckpoint::readHeader(QDataStream& inout_stream, qint64& out_resumeOffset) const
+{
+    quint32 magic = 0;
+    quint32 version = 0;
+    QString sourceFileName;
+    qint64 sourceSize = -1;
+    qint64 sourceLastModified = -1;
+    qint64 resumeOffset = -1;
+    inout_stream >> magic >> version >> sourceFileName >> sourceSize >> sourceLastModified >> resumeOffset;
+    if (inout_stream.status() != QDataStream::Ok || magic != Magic || version != Version) {
+        return false;
+    }
+    if (sourceFileName != m_sourceFileName || sourceSize != m_sourceSize || sourceLastModified != m_sourceLastModified
+            || resumeOffset < 0 || resumeOffset > m_sourceSize) {
+        return false;
+    }
+    out_resumeOffset = resumeOffset;
+    return true;
+}
+
+void CCheckpoint::remove() const
+{
+    if (isEnabled()) {
+        QFile::remove(m_fileName);
+    }
+}
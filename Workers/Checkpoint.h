@@ -0,0 +1,55 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <QString>
+#include <QDataStream>
+
+#include <functional>
+
+//! The CCheckpoint class writes and reads checkpoints of text analyzing: the analyzer's state and the offset in the analyzed file,
+//! from which reading is resumed. A checkpoint is written atomically, so an interrupted writing keeps the previous checkpoint.
+//! It's read only for the same unchanged file: its path, size and modification time are stored in the checkpoint.
+class CCheckpoint
+{
+public:
+    //! Returns the checkpoint's file name in the temporary directory, which is unique for the analyzed file.
+    static QString DefaultFileName(const QString& in_sourceFileName);
+
+    //! Sets the checkpoint's file name. Checkpoints are disabled if it's empty, it's the default.
+    void setFileName(const QString& in_fileName);
+    const QString& fileName() const { return m_fileName; }
+    bool isEnabled() const { return !m_fileName.isEmpty(); }
+
+    //! Sets the analyzed file, which checkpoints belong to. Its size and modification time are taken now.
+    void setSourceFileName(const QString& in_sourceFileName);
+    qint64 sourceSize() const { return m_sourceSize; }
+
+    //! Writes the checkpoint atomically.
+    //! @param in_writeState [in] - writes the analyzer's state to the stream.
+    //! @return false if the checkpoint couldn't be written.
+    bool write(qint64 in_resumeOffset, const std::function<void(QDataStream&)>& in_writeState) const;
+
+    //! Reads the checkpoint of the analyzed file.
+    //! @param in_readState [in] - reads the analyzer's state from the stream and returns false if it's invalid.
+    //! @return false if there isn't a valid checkpoint of the unchanged analyzed file.
+    bool read(qint64& out_resumeOffset, const std::function<bool(QDataStream&)>& in_readState) const;
+
+    //! Checks if there is a checkpoint of the unchanged analyzed file without reading the analyzer's state, so it's cheap enough
+    //! to ask the user whether to resume. The state may still turn out to be invalid or written in other settings.
+    //! @param out_resumeOffset [out] - the offset, from which reading would be resumed.
+    bool isAvailable(qint64& out_resumeOffset) const;
+
+    //! Removes the checkpoint's file.
+    void remove() const;
+
+private:
+    //! Reads the header of the checkpoint and checks that it belongs to the unchanged analyzed file.
+    bool readHeader(QDataStream& inout_stream, qint64& out_resumeOffset) const;
+
+    QString m_fileName;
+    QString m_sourceFileName;       //!< The absolute path of the analyzed file.
+    qint64 m_sourceSize { -1 };
+    qint64 m_sourceLastModified { -1 }; //!< Milliseconds since the epoch.
+};
+
+#endif // CHECKPOINT_H
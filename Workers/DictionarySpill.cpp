@@ -0,0 +1,191 @@
+#include "DictionarySpill.h"
+
+#include <QDir>
+#include <QFile>
+#include <QDataStream>
+
+#include <algorithm>
+#include <queue>
+
+namespace {
+
+    //! Returns identifiers of letter combinations with non-zero counts sorted by letter combinations.
+    std::vector<quint32> sortedIds(const CStringInterner& in_dictionary, const std::vector<quint64>& in_counts)
+    {
+        std::vector<quint32> ids;
+        ids.reserve(in_dictionary.size());
+        for (quint32 id = 0; id < in_dictionary.size(); ++id) {
+            if (in_counts[id]) {
+                ids.push_back(id);
+            }
+        }
+        std::sort(std::begin(ids), std::end(ids), [&in_dictionary](quint32 lhs, quint32 rhs){
+            return in_dictionary.isLess(lhs, rhs);
+        });
+        return ids;
+    }
+
+    //! Reads records of a run from the file or from the dictionary in memory one by one.
+    class CRunReader
+    {
+    public:
+        explicit CRunReader(const QString& in_fileName)
+            : m_file(in_fileName)
+        {
+            if (m_file.open(QIODevice::ReadOnly)) {
+                m_stream.setDevice(&m_file);
+            }
+        }
+
+        CRunReader(const CStringInterner& in_dictionary, const std::vector<quint64>& in_counts)
+            : m_dictionary(&in_dictionary)
+            , m_counts(&in_counts)
+            , m_ids(sortedIds(in_dictionary, in_counts))
+        {}
+
+        //! Reads the next record.
+        //! @return false at the end of the run.
+        bool next()
+        {
+            if (m_dictionary) {
+                if (m_nextId == m_ids.size()) {
+                    return false;
+                }
+                const quint32 id = m_ids[m_nextId++];
+                m_letterCombination = QByteArray(m_dictionary->data(id), m_dictionary->size(id));
+                m_count = (*m_counts)[id];
+                return true;
+            }
+            if (!m_stream.device() || m_stream.atEnd()) {
+                return false;
+            }
+            m_stream >> m_letterCombination >> m_count;
+            return m_stream.status() == QDataStream::Ok;
+        }
+
+        const QByteArray& letterCombination() const { return m_letterCombination; }
+        quint64 count() const { return m_count; }
+
+    private:
+        QFile m_file;
+        QDataStream m_stream;
+        const CStringInterner* m_dictionary { nullptr };
+        const std::vector<quint64>* m_counts { nullptr };
+        std::vector<quint32> m_ids;
+        size_t m_nextId { 0 };
+        QByteArray m_letterCombination;
+        quint64 m_count { 0 };
+    };
+
+    bool isBetter(const QPair<QByteArray, quint64>& lhs, const QPair<QByteArray, quint64>& rhs)
+    {
+        return lhs.second != rhs.second ? lhs.second > rhs.second : lhs.first < rhs.first;
+    }
+
+} // namespace
+
+CDictionarySpill::CDictionarySpill()
+    : m_directory(QDir::tempPath())
+{}
+
+CDictionarySpill::~CDictionarySpill() {}
+
+void CDictionarySpill::setDirectory(const QString& in_directory)
+{
+    m_directory = in_directory.isEmpty() ? QDir::tempPath() : in_directory;
+}
+
+bool CDictionarySpill::writeRun(const CStringInterner& in_dictionary, const std::vector<quint64>& in_counts)
+{
+    if (!m_runsDirectory) {
+        m_runsDirectory.reset(new QTemporaryDir(QDir(m_directory).filePath("TextAnalyzer-XXXXXX")));
+        if (!m_runsDirectory->isValid()) {
+            m_errorString = QString("the directory of counts can't be created in %1").arg(QDir::toNativeSeparators(m_directory));
+            m_runsDirectory.reset();
+            return false;
+        }
+    }
+
+    const QString fileName = m_runsDirectory->filePath(QString("run%1").arg(m_runsFiles.size()));
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        m_errorString = QString("%1 can't be created: %2").arg(QDir::toNativeSeparators(fileName), file.errorString());
+        return false;
+    }
+    QDataStream stream(&file);
+    for (const auto id : sortedIds(in_dictionary, in_counts)) {
+        stream << QByteArray::fromRawData(in_dictionary.data(id), in_dictionary.size(id)) << in_counts[id];
+    }
+    file.close();
+    if (stream.status() != QDataStream::Ok || file.error() != QFileDevice::NoError) {
+        m_errorString = QString("%1 can't be written: %2").arg(QDir::toNativeSeparators(fileName), file.errorString());
+        file.remove();
+        return false;
+    }
+    m_runsFiles.push_back(fileName);
+    return true;
+}
+
+WordsVector CDictionarySpill::mergeTop(const CStringInterner& in_dictionary, const std::vector<quint64>& in_counts, int in_count) const
+{
+    // The top is kept as a heap with the worst letter combination at the front.
+    std::vector<QPair<QByteArray, quint64>> top;
+    merge(in_dictionary, in_counts, [&top, in_count](const QByteArray& letterCombination, quint64 count){
+        if (static_cast<int>(top.size()) < in_count) {
+            top.push_back({ letterCombination, count });
+            std::push_heap(std::begin(top), std::end(top), isBetter);
+        } else if (in_count > 0 && isBetter({ letterCombination, count }, top.front())) {
+            std::pop_heap(std::begin(top), std::end(top), isBetter);
+            top.back() = { letterCombination, count };
+            std::push_heap(std::begin(top), std::end(top), isBetter);
+        }
+    });
+
+    std::sort(std::begin(top), std::end(top), isBetter);
+    WordsVector result;
+    for (const auto& letterCombination : top) {
+        result.push_back(QPair(QString::fromUtf8(letterCombination.first), letterCombination.second));
+    }
+    return result;
+}
+
+void CDictionarySpill::merge(const CStringInterner& in_dictionary, const std::vector<quint64>& in_counts,
+                             const std::function<void(const QByteArray&, quint64)>& in_onLetterCombination) const
+{
+    std::vector<std::unique_ptr<CRunReader>> readers;
+    for (const auto& runFile : m_runsFiles) {
+        readers.push_back(std::make_unique<CRunReader>(runFile));
+    }
+    readers.push_back(std::make_unique<CRunReader>(in_dictionary, in_counts));
+
+    // Merge runs by the heap of their current letter combinations.
+    auto isGreater = [&readers](size_t lhs, size_t rhs){
+        return readers[rhs]->letterCombination() < readers[lhs]->letterCombination();
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(isGreater)> runs(isGreater);
+    for (size_t i = 0; i < readers.size(); ++i) {
+        if (readers[i]->next()) {
+            runs.push(i);
+        }
+    }
+
+    while (!runs.empty()) {
+        QPair<QByteArray, quint64> letterCombination(readers[runs.top()]->letterCombination(), 0);
+        while (!runs.empty() && readers[runs.top()]->letterCombination() == letterCombination.first) {
+            const size_t run = runs.top();
+            runs.pop();
+            letterCombination.second += readers[run]->count();
+            if (readers[run]->next()) {
+                runs.push(run);
+            }
+        }
+
+        in_onLetterCombination(letterCombination.first, letterCombination.second);
+    }
+}
+
+void CDictionarySpill::clear()
+{
+    m_runsFiles.clear();
+    m_runsDirectory.reset();
+}
@@ -0,0 +1,54 @@
+#ifndef DICTIONARYSPILL_H
+#define DICTIONARYSPILL_H
+
+#include "CommonData.h"
+#include "StringInterner.h"
+
+#include <QString>
+#include <QTemporaryDir>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+//! The CDictionarySpill class stores letter combinations' counts on disk as runs sorted by letter combinations.
+//! A run is written when the dictionary reaches its memory budget, then the dictionary is cleared. Runs are merged at the end:
+//! counts of equal letter combinations from all runs are summed, so the resulting top is exact.
+class CDictionarySpill
+{
+public:
+    CDictionarySpill();
+    ~CDictionarySpill();
+
+    //! Sets the directory of runs' files. The system temporary directory is used by default.
+    void setDirectory(const QString& in_directory);
+
+    //! Writes letter combinations with non-zero counts sorted by letter combinations as a new run.
+    //! @return false if the run couldn't be written.
+    bool writeRun(const CStringInterner& in_dictionary, const std::vector<quint64>& in_counts);
+
+    //! Merges all runs with the dictionary in memory and returns the given number of the most common letter combinations
+    //! in count descending order. Equal counts are ordered by letter combinations.
+    WordsVector mergeTop(const CStringInterner& in_dictionary, const std::vector<quint64>& in_counts, int in_count) const;
+
+    //! Merges all runs with the dictionary in memory and passes every letter combination with its total count to the handler
+    //! in letter combinations' order.
+    void merge(const CStringInterner& in_dictionary, const std::vector<quint64>& in_counts,
+               const std::function<void(const QByteArray&, quint64)>& in_onLetterCombination) const;
+
+    int runsCount() const { return static_cast<int>(m_runsFiles.size()); }
+
+    //! Returns the reason, why the last run couldn't be written.
+    QString errorString() const { return m_errorString; }
+
+    //! Removes all runs.
+    void clear();
+
+private:
+    QString m_directory;
+    std::unique_ptr<QTemporaryDir> m_runsDirectory;
+    std::vector<QString> m_runsFiles;
+    QString m_errorString;
+};
+
+#endif // DICTIONARYSPILL_H
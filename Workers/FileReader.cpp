@@ -1,135 +1,506 @@
 #include "FileReader.h"
+#include "Tracing.h"
+#include "AllocationProfiler.h"
 
-#include <QFile>
-#include <QTextStream>
+#include <QFileInfo>
+#include <QThread>
+#include <QQueue>
+#include <QFuture>
+#include <QtConcurrent>
 
-#include <regex>
+#include <algorithm>
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+    // Reserved capacity of the lowercase word buffers. Words are usually much shorter, longer words grow the buffer once.
+    constexpr int ReservedWordSize = 256;
+
+    // Push a words batch after processing of this amount of text.
+    constexpr qint64 BytesToProcess = 4096 * 100;
+
+    //! Counts the given UTF-8 word in lowercase.
+    //! @param inout_lowerCaseWord [in, out] - the buffer with reserved capacity for the lowercase word.
+    void addWordToBatch(const char* in_word, int in_size, QByteArray& inout_lowerCaseWord, CWordsBatch& inout_batch)
+    {
+        inout_lowerCaseWord.resize(0);
+        TextEncoding::AppendLowerCase(in_word, in_size, inout_lowerCaseWord);
+        inout_batch.addWord(inout_lowerCaseWord.constData(), inout_lowerCaseWord.size());
+    }
+
+    //! Splits the given UTF-8 byte range to individual words and counts them. The range must be aligned to words' boundaries.
+    void countRangeWords(const char* in_data, qint64 in_size, CWordsBatch* inout_batch)
+    {
+        const Tracing::CSpan span("FileReader::countRangeWords");
+        const AllocationProfiler::CStageScope stage(AllocationProfiler::esTokenizer);
+        CWordTokenizer tokenizer;
+        QByteArray lowerCaseWord;
+        lowerCaseWord.reserve(ReservedWordSize);
+        auto onWord = [&lowerCaseWord, inout_batch](const char* in_word, int in_wordSize){
+            addWordToBatch(in_word, in_wordSize, lowerCaseWord, *inout_batch);
+        };
+        tokenizer.feed(in_data, in_size, onWord);
+        tokenizer.finish(onWord);
+    }
+
+} // namespace
+
+CFileReaderWorker::CFileReaderWorker()
+    : m_fileSystemWatcher(this)
+{
+    m_threadPool.setMaxThreadCount(QThread::idealThreadCount());
+    m_lowerCaseWord.reserve(ReservedWordSize);
+    m_utf8Chunk.reserve(2 * BytesToProcess);
+    QObject::connect(&m_fileSystemWatcher, &QFileSystemWatcher::fileChanged, this, &CFileReaderWorker::readAppendedData);
+    QObject::connect(&m_fileSystemWatcher, &QFileSystemWatcher::directoryChanged, this, &CFileReaderWorker::readAppendedData);
+}
 
-CFileReaderWorker::CFileReaderWorker() {}
 CFileReaderWorker::~CFileReaderWorker() {}
 
+void CFileReaderWorker::setReadingMode(CommonData::EFileReadingMode in_readingMode)
+{
+    m_readingMode = in_readingMode;
+}
+
+void CFileReaderWorker::setThreadsCount(int in_threadsCount)
+{
+    m_threadPool.setMaxThreadCount(in_threadsCount > 0 ? in_threadsCount : QThread::idealThreadCount());
+}
+
+void CFileReaderWorker::setWordsBatchQueue(const QSharedPointer<CWordsBatchQueue>& in_wordsBatchQueue)
+{
+    m_wordsBatchQueue = in_wordsBatchQueue;
+}
+
+void CFileReaderWorker::setPipelineMetrics(const QSharedPointer<CPipelineMetrics>& in_pipelineMetrics)
+{
+    m_pipelineMetrics = in_pipelineMetrics;
+}
+
+void CFileReaderWorker::setFollowMode(bool in_isFollowMode)
+{
+    m_isFollowMode = in_isFollowMode;
+}
+
+void CFileReaderWorker::setStartOffset(qint64 in_offset)
+{
+    m_startOffset = std::max(in_offset, qint64(0));
+}
+
+void CFileReaderWorker::processFrom(const QString& in_fileName, qint64 in_startOffset)
+{
+    setStartOffset(in_startOffset);
+    process(in_fileName);
+}
+
 void CFileReaderWorker::process(const QString& in_fileName)
 {
+    Q_ASSERT(m_wordsBatchQueue);
+    const Tracing::CSpan span("FileReader::process");
+    const AllocationProfiler::CStageScope stage(AllocationProfiler::esReader);
     m_isStop = false;
+    const qint64 startOffset = m_startOffset;
+    m_startOffset = 0;
+
+    // The batch is kept if the previous processing has been interrupted.
+    if (!m_batch) {
+        m_batch = m_wordsBatchQueue->acquire();
+        if (!m_batch) {
+            emit statusChanged(CommonData::efrsFileProcessingInterrupted);
+            return;
+        }
+    }
+    m_batch->clear();
+
+    if (m_isFollowMode) {
+        if (startOffset > 0) {
+            m_wordsBatchQueue->close();
+            emit statusChanged(CommonData::efrsFileResumeError);
+            return;
+        }
+        startFollowing(in_fileName);
+        return;
+    }
+
     QFile file(in_fileName);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_wordsBatchQueue->close();
         emit statusChanged(CommonData::efrsFileOpenError);
         return;
     }
 
-    constexpr qint64 maxChunkSize = 4096;
-    constexpr unsigned int chunksToProcess = 100;
-    QString remainder;
-    QTextStream textStream(&file);
-    QString chunk = textStream.readLine(maxChunkSize);
-    unsigned int chunkCounter = 0;
-    while (!chunk.isNull()) {
-        ++chunkCounter;
-        if (m_isStop) {
-            emit statusChanged(CommonData::efrsFileProcessingInterrupted);
+    bool isFinished = false;
+    m_contentHasher.reset();
+    uchar* mappedData = nullptr;
+    const qint64 fileSize = file.size();
+    if (m_pipelineMetrics) {
+        // The size of pipes and other sequential inputs is unknown.
+        m_pipelineMetrics->startReading(file.isSequential() ? -1 : fileSize, startOffset);
+    }
+
+    // Pipes, character devices and empty files can't be mapped.
+    if (m_readingMode != CommonData::efrmStreamed && !file.isSequential() && fileSize > 0) {
+        mappedData = file.map(0, fileSize);
+    }
+
+    if (mappedData) {
+#ifdef Q_OS_UNIX
+        posix_madvise(mappedData, static_cast<size_t>(fileSize), POSIX_MADV_SEQUENTIAL);
+#endif
+        const char* data = reinterpret_cast<const char*>(mappedData);
+        int bomSize = 0;
+        const auto encoding = TextEncoding::DetectEncoding(data, fileSize, bomSize);
+
+        // Resume offsets are words' boundaries of UTF-8 text, the transcoder's state of other encodings isn't restorable.
+        if (startOffset > 0 && encoding != CommonData::eteUtf8) {
+            file.unmap(mappedData);
+            m_wordsBatchQueue->close();
+            emit statusChanged(CommonData::efrsFileResumeError);
             return;
         }
-        processChunk(chunk, maxChunkSize, remainder, m_words);
-        if (!(chunkCounter % chunksToProcess)) {
-            emit chunkProcessed(m_words);
-            m_words.clear();
-            chunkCounter = 0;
+        const qint64 dataOffset = std::min(std::max(startOffset, static_cast<qint64>(bomSize)), fileSize);
+        m_contentHasher.add(data, dataOffset);
+
+        // Byte ranges are aligned to words' boundaries in UTF-8, text in other encodings is converted sequentially.
+        if (m_readingMode == CommonData::efrmParallel && encoding == CommonData::eteUtf8) {
+            isFinished = processMappedDataInParallel(data + dataOffset, fileSize - dataOffset, dataOffset);
+        } else {
+            isFinished = processMappedData(data + dataOffset, fileSize - dataOffset, dataOffset, encoding);
         }
-        chunk = textStream.readLine(maxChunkSize);
+        file.unmap(mappedData);
+    } else if (startOffset > 0) {
+        m_wordsBatchQueue->close();
+        emit statusChanged(CommonData::efrsFileResumeError);
+        return;
+    } else {
+        isFinished = processStream(file);
     }
-    if (!m_words.isEmpty()) {
-        emit chunkProcessed(m_words);
-        m_words.clear();
+
+    if (!isFinished) {
+        m_tokenizer.reset();
+        if (m_batch) {
+            m_batch->clear();
+        }
     }
-    if (!remainder.isEmpty()) {
-        emit chunkProcessed({ { remainder, 1 } });
+    m_wordsBatchQueue->close();
+    if (isFinished && !startOffset) {
+        emit contentHashCalculated(m_contentHasher.result());
     }
-    emit statusChanged(CommonData::efrsFileProcessingFinished);
+    emit statusChanged(isFinished ? CommonData::efrsFileProcessingFinished : CommonData::efrsFileProcessingInterrupted);
 }
 
-void CFileReaderWorker::stopProcessing()
+bool CFileReaderWorker::processStream(QFile& inout_file)
 {
-    m_isStop = true;
+    constexpr qint64 maxChunkSize = 64 * 1024;
+
+    // The encoding is detected by the first chunk.
+    QByteArray chunk(static_cast<int>(maxChunkSize), Qt::Uninitialized);
+    qint64 chunkSize = inout_file.read(chunk.data(), maxChunkSize);
+    int bomSize = 0;
+    m_transcoder.setEncoding(TextEncoding::DetectEncoding(chunk.constData(), std::max(chunkSize, qint64(0)), bomSize));
+    qint64 chunkOffset = bomSize;
+    qint64 bytesProcessed = 0;
+    qint64 fileOffset = 0;
+    while (chunkSize > 0) {
+        if (m_isStop) {
+            return false;
+        }
+        m_contentHasher.add(chunk.constData(), chunkSize);
+        processData(chunk.constData() + chunkOffset, chunkSize - chunkOffset);
+        bytesProcessed += chunkSize - chunkOffset;
+        fileOffset += chunkSize;
+        if (m_pipelineMetrics) {
+            m_pipelineMetrics->setFileOffset(fileOffset);
+        }
+        if (bytesProcessed >= BytesToProcess) {
+            if (!pushBatch()) {
+                return false;
+            }
+            bytesProcessed = 0;
+        }
+        chunkOffset = 0;
+        chunkSize = inout_file.read(chunk.data(), maxChunkSize);
+    }
+    return finishData();
 }
 
-void CFileReaderWorker::processChunk(const QString& in_chunk, qint64 in_maxChunkSize, QString& inout_remainder, WordsMap& inout_words)
+bool CFileReaderWorker::processMappedData(const char* in_data, qint64 in_size, qint64 in_fileOffset, CommonData::ETextEncoding in_encoding)
 {
-    auto addWordToMap = [&inout_words](const QString& in_word){
-        if (!in_word.isEmpty()) {
-            if (!inout_words.contains(in_word)) {
-                inout_words[in_word] = 1;
-            } else {
-                ++inout_words[in_word];
-            }
+    m_transcoder.setEncoding(in_encoding);
+    const bool isUtf8 = in_encoding == CommonData::eteUtf8;
+    for (qint64 offset = 0; offset < in_size; ) {
+        if (m_isStop) {
+            return false;
+        }
+
+        // UTF-8 chunks end at words' boundaries, so reading may be resumed after any pushed batch.
+        const qint64 chunkEnd = isUtf8 ? CWordTokenizer::findWordBoundary(in_data, in_size, std::min(offset + BytesToProcess, in_size))
+                                       : std::min(offset + BytesToProcess, in_size);
+        m_contentHasher.add(in_data + offset, chunkEnd - offset);
+        processData(in_data + offset, chunkEnd - offset);
+        if (isUtf8) {
+            finishWord();
+            m_batch->setResumeOffset(in_fileOffset + chunkEnd);
+        }
+        offset = chunkEnd;
+        if (m_pipelineMetrics) {
+            m_pipelineMetrics->setFileOffset(in_fileOffset + chunkEnd);
+        }
+        if (!pushBatch()) {
+            return false;
+        }
+    }
+    return finishData();
+}
+
+bool CFileReaderWorker::processMappedDataInParallel(const char* in_data, qint64 in_size, qint64 in_fileOffset)
+{
+    // The range size is big enough to amortize the thread pool overhead and small enough to push words regularly.
+    constexpr qint64 rangeSize = 4 * 1024 * 1024;
+
+    // Keep twice as many ranges in flight as there are threads, so the pool doesn't idle while ranges' words are merged.
+    // Ranges are merged in the file order, so the batch of the range being enqueued is always free.
+    const int threadsCount = m_threadPool.maxThreadCount();
+    const int rangesInFlightCount = 2 * threadsCount;
+    while (static_cast<int>(m_rangeBatches.size()) < rangesInFlightCount) {
+        m_rangeBatches.push_back(std::make_unique<CWordsBatch>());
+    }
+
+    struct SRange
+    {
+        QFuture<void> future;
+        CWordsBatch* batch;
+        qint64 end;
+    };
+    QQueue<SRange> ranges;
+    auto waitForRanges = [&ranges](){
+        // The mapped data must not be unmapped while it's being processed.
+        for (auto& range : ranges) {
+            range.future.waitForFinished();
         }
     };
 
-    auto reduceWordCountInMap = [&inout_words](const QString& in_word) {
-        if (!in_word.isEmpty()) {
-            if (inout_words.contains(in_word)) {
-                --inout_words[in_word];
-                if (!inout_words[in_word]) {
-                    inout_words.remove(in_word);
-                }
-            }
+    qint64 offset = 0;
+    int enqueuedRangesCount = 0;
+    int mergedRangesCount = 0;
+    while (offset < in_size || !ranges.isEmpty()) {
+        while (offset < in_size && ranges.size() < rangesInFlightCount) {
+            const qint64 rangeEnd = CWordTokenizer::findWordBoundary(in_data, in_size, std::min(offset + rangeSize, in_size));
+            CWordsBatch* rangeBatch = m_rangeBatches[enqueuedRangesCount++ % rangesInFlightCount].get();
+            rangeBatch->clear();
+            m_contentHasher.add(in_data + offset, rangeEnd - offset);
+            ranges.enqueue({ QtConcurrent::run(&m_threadPool, countRangeWords, in_data + offset, rangeEnd - offset, rangeBatch), rangeBatch, rangeEnd });
+            offset = rangeEnd;
+        }
+
+        if (m_isStop) {
+            waitForRanges();
+            return false;
+        }
+
+        auto range = ranges.dequeue();
+        {
+            const Tracing::CSpan span("FileReader::mergeRange");
+            const AllocationProfiler::CStageScope stage(AllocationProfiler::esTokenizer);
+            range.future.waitForFinished();
+            m_batch->merge(*range.batch);
+        }
+        m_batch->setResumeOffset(in_fileOffset + range.end);
+        if (m_pipelineMetrics) {
+            m_pipelineMetrics->setFileOffset(in_fileOffset + range.end);
         }
+        if (!(++mergedRangesCount % threadsCount) && !pushBatch()) {
+            waitForRanges();
+            return false;
+        }
+    }
+    return pushBatch();
+}
+
+void CFileReaderWorker::processData(const char* in_data, qint64 in_size)
+{
+    const Tracing::CSpan span("FileReader::processData");
+    const AllocationProfiler::CStageScope stage(AllocationProfiler::esTokenizer);
+    auto onWord = [this](const char* in_word, int in_wordSize){
+        addWordToBatch(in_word, in_wordSize, m_lowerCaseWord, *m_batch);
     };
 
-    // Split the given string to individual words divided by whitespace and punctuation characters.
-    std::wregex rx(L"[[:space:][:punct:]]+");
-    std::wstring chunk((const wchar_t*)in_chunk.utf16());
-    std::wsregex_token_iterator wordsIt(std::begin(chunk), std::end(chunk), rx, -1), wordsEndIt;
-    QString firstWord, lastWord;
-    int wordsCounter = 0;
-    while (wordsIt != wordsEndIt) {
-        QString word = QString::fromStdWString(*wordsIt);
-        word = word.toLower();  // Consider words in lowercase.
-        if (!wordsCounter) {
-            firstWord = word;
-        }
-        lastWord = word;
-        ++wordsIt;
-        if (!word.isEmpty()) {
-            addWordToMap(word);
-            ++wordsCounter;
-        }
-    }
-
-    if (wordsCounter == 1) {
-        lastWord.clear();
-    }
-
-    // Analyze the chunk's head.
-    int firstWordIndex = in_chunk.indexOf(firstWord, 0, Qt::CaseInsensitive);
-    const bool chunkEndsWithFirstWord = in_chunk.endsWith(firstWord, Qt::CaseInsensitive);
-    bool remainderFilled = false;
-
-    // If chunk begins from the first word, then there aren't any whitespace or punctuation symbols before.
-    // If not, then take and "stitch" it with the remainder word from the previous chunk.
-    if (!firstWord.isEmpty() && !firstWordIndex && !inout_remainder.isEmpty()) {
-        // Merge word head (the last word) from the previous chunk with word tail (the first word) from the current chunk.
-        reduceWordCountInMap(firstWord);
-        QString assembledRemainderWord = firstWord;
-        assembledRemainderWord.prepend(inout_remainder);
-        if ((wordsCounter == 1 && !chunkEndsWithFirstWord) || (wordsCounter == 1 && chunkEndsWithFirstWord && in_chunk.size() < in_maxChunkSize) || wordsCounter > 1) {
-            addWordToMap(assembledRemainderWord);
-            inout_remainder.clear();
-        } else {
-            inout_remainder = assembledRemainderWord;
-            remainderFilled = true;
+    // UTF-8 text is split as is, text in other encodings is converted to UTF-8 at first.
+    if (m_transcoder.encoding() == CommonData::eteUtf8) {
+        m_tokenizer.feed(in_data, in_size, onWord);
+    } else {
+        m_utf8Chunk.resize(0);
+        m_transcoder.transcode(in_data, in_size, m_utf8Chunk);
+        m_tokenizer.feed(m_utf8Chunk.constData(), m_utf8Chunk.size(), onWord);
+    }
+}
+
+void CFileReaderWorker::finishWord()
+{
+    m_tokenizer.finish([this](const char* in_word, int in_wordSize){
+        addWordToBatch(in_word, in_wordSize, m_lowerCaseWord, *m_batch);
+    });
+}
+
+bool CFileReaderWorker::finishData()
+{
+    finishWord();
+    m_transcoder.reset();
+    return pushBatch();
+}
+
+bool CFileReaderWorker::pushBatch()
+{
+    if (m_batch->isEmpty()) {
+        return true;
+    }
+
+    // The span includes waiting for a free batch, while the text analyzer lags behind.
+    const Tracing::CSpan span("FileReader::pushBatch");
+    m_wordsBatchQueue->push(std::move(m_batch));
+    m_batch = m_wordsBatchQueue->acquire();
+    return m_batch != nullptr;
+}
+
+void CFileReaderWorker::stopProcessing()
+{
+    m_isStop = true;
+
+    // The followed file is read in the worker's thread, so following is finished there.
+    QMetaObject::invokeMethod(this, [this](){
+        if (!m_followedFileName.isEmpty()) {
+            finishFollowing();
         }
-    } else if (!inout_remainder.isEmpty()) {
-        addWordToMap(inout_remainder);
-        inout_remainder.clear();
+    }, Qt::QueuedConnection);
+}
+
+void CFileReaderWorker::startFollowing(const QString& in_fileName)
+{
+    m_followedFileName = QFileInfo(in_fileName).absoluteFilePath();
+    m_followedFile.setFileName(m_followedFileName);
+    m_followedOffset = 0;
+    if (!m_followedFile.open(QIODevice::ReadOnly)) {
+        m_followedFileName.clear();
+        m_wordsBatchQueue->close();
+        emit statusChanged(CommonData::efrsFileOpenError);
+        return;
     }
+    m_fileSystemWatcher.addPath(m_followedFileName);
+    m_fileSystemWatcher.addPath(QFileInfo(m_followedFileName).absolutePath());
+    if (m_pipelineMetrics) {
+        m_pipelineMetrics->startReading(m_followedFile.size(), 0);
+    }
+    readAppendedData();
+}
+
+void CFileReaderWorker::readAppendedData()
+{
+    if (m_followedFileName.isEmpty() || m_isStop) {
+        return;
+    }
+    const Tracing::CSpan span("FileReader::readAppendedData");
+    const AllocationProfiler::CStageScope stage(AllocationProfiler::esReader);
+
+    // The file is read from the beginning again if it has been truncated or replaced by a new one. The last word of the previous data is complete.
+    const QFileInfo followedFileInfo(m_followedFileName);
+    if (!m_followedFile.isOpen() || isFollowedFileReplaced() || (followedFileInfo.exists() && followedFileInfo.size() < m_followedOffset)) {
+        // Data appended to the rotated file before its replacement is read through the open handle first.
+        if (m_followedFile.isOpen() && !readFollowedData()) {
+            finishFollowing();
+            return;
+        }
+        if (!followedFileInfo.exists()) {
+            // The rotated file hasn't been created yet, the directory's change is waited.
+            return;
+        }
+        finishWord();
+        m_transcoder.reset();
+        m_followedFile.close();
+        m_followedOffset = 0;
+        if (!m_followedFile.open(QIODevice::ReadOnly)) {
+            return;
+        }
+    }
+
+    // The watch of a removed file is dropped, so the new file is watched again.
+    if (!m_fileSystemWatcher.files().contains(m_followedFileName)) {
+        m_fileSystemWatcher.addPath(m_followedFileName);
+    }
+
+    if (m_pipelineMetrics) {
+        m_pipelineMetrics->setFileSize(m_followedFile.size());
+    }
+    if (!readFollowedData()) {
+        finishFollowing();
+    }
+}
+
+bool CFileReaderWorker::readFollowedData()
+{
+    if (m_followedFile.size() <= m_followedOffset || !m_followedFile.seek(m_followedOffset)) {
+        return true;
+    }
+    QByteArray chunk(static_cast<int>(BytesToProcess), Qt::Uninitialized);
+    while (!m_isStop) {
+        const qint64 chunkSize = m_followedFile.read(chunk.data(), BytesToProcess);
+        if (chunkSize <= 0) {
+            break;
+        }
 
-    // Analyze the chunk's tail.
-    // Check and save remainder word, if necessary.
-    if (!lastWord.isEmpty() && in_chunk.size() == in_maxChunkSize && in_chunk.endsWith(lastWord, Qt::CaseInsensitive)) {
-        inout_remainder = lastWord;
-        reduceWordCountInMap(lastWord);
-    } else if (!remainderFilled && lastWord.isEmpty() && wordsCounter == 1 && !firstWord.isEmpty() && in_chunk.size() == in_maxChunkSize && chunkEndsWithFirstWord) {
-        inout_remainder = firstWord;
-        reduceWordCountInMap(firstWord);
+        // The encoding is detected by the beginning of the file.
+        qint64 chunkOffset = 0;
+        if (!m_followedOffset) {
+            int bomSize = 0;
+            m_transcoder.setEncoding(TextEncoding::DetectEncoding(chunk.constData(), chunkSize, bomSize));
+            chunkOffset = bomSize;
+        }
+        m_followedOffset += chunkSize;
+
+        // The last word may be incomplete yet, so it's kept in the tokenizer until the following data.
+        processData(chunk.constData() + chunkOffset, chunkSize - chunkOffset);
+        if (m_pipelineMetrics) {
+            m_pipelineMetrics->setFileOffset(m_followedOffset);
+        }
+        if (!pushBatch()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CFileReaderWorker::finishFollowing()
+{
+    if (!m_fileSystemWatcher.files().isEmpty()) {
+        m_fileSystemWatcher.removePaths(m_fileSystemWatcher.files());
+    }
+    if (!m_fileSystemWatcher.directories().isEmpty()) {
+        m_fileSystemWatcher.removePaths(m_fileSystemWatcher.directories());
+    }
+    m_followedFile.close();
+    m_followedFileName.clear();
+    m_followedOffset = 0;
+
+    // Following has no end of the file, so stopping finishes processing of the read data.
+    const bool isFinished = m_batch && finishData();
+    m_wordsBatchQueue->close();
+    emit statusChanged(isFinished ? CommonData::efrsFileProcessingFinished : CommonData::efrsFileProcessingInterrupted);
+}
+
+bool CFileReaderWorker::isFollowedFileReplaced() const
+{
+#ifdef Q_OS_UNIX
+    struct stat openFileStat;
+    struct stat namedFileStat;
+    if (fstat(m_followedFile.handle(), &openFileStat) || stat(QFile::encodeName(m_followedFileName).constData(), &namedFileStat)) {
+        return true;
     }
+    return openFileStat.st_dev != namedFileStat.st_dev || openFileStat.st_ino != namedFileStat.st_ino;
+#else
+    // Files' identities aren't compared on other platforms, a rotated file is detected by its smaller size.
+    return false;
+#endif
 }
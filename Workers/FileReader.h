@@ -2,9 +2,21 @@
 #define FILEREADER_H
 
 #include "CommonData.h"
+#include "WordTokenizer.h"
+#include "TextEncoding.h"
+#include "WordsBatchQueue.h"
+#include "PipelineMetrics.h"
+#include "ResultCache.h"
 
 #include <QObject>
 #include <QAtomicInteger>
+#include <QThreadPool>
+#include <QSharedPointer>
+#include <QFile>
+#include <QFileSystemWatcher>
+
+#include <memory>
+#include <vector>
 
 class CFileReaderWorker : public QObject
 {
@@ -14,26 +26,113 @@ public:
     CFileReaderWorker();
     ~CFileReaderWorker();
 
+    //! Sets the file reading mode from the CommonData::EFileReadingMode enumeration. Memory-mapped mode is used by default.
+    void setReadingMode(CommonData::EFileReadingMode in_readingMode);
+
+    //! Sets the number of threads counting words in the CommonData::efrmParallel mode. The ideal thread count is used if the value isn't positive.
+    void setThreadsCount(int in_threadsCount);
+
+    //! Sets the queue, which passes words batches to the text analyzer. The queue is closed when file processing is finished.
+    void setWordsBatchQueue(const QSharedPointer<CWordsBatchQueue>& in_wordsBatchQueue);
+
+    //! Sets the registry of live metrics, which is updated with the file size and the read offset after every chunk.
+    //! Metrics aren't published if it's null, it's the default.
+    void setPipelineMetrics(const QSharedPointer<CPipelineMetrics>& in_pipelineMetrics);
+
+    //! Enables the follow mode: when the file is read to the end, it's watched and appended data is read as it arrives,
+    //! so the cost of an update depends on the appended data only. A truncated or rotated file is read from the beginning again.
+    //! The file is read by chunks as in the CommonData::efrmStreamed mode, following is finished by stopProcessing().
+    void setFollowMode(bool in_isFollowMode);
+
+    //! Sets the file offset, from which the next process() call starts reading, to resume from a checkpoint. Zero means the beginning.
+    //! Reading may be resumed in the memory-mapped and parallel modes of UTF-8 files, they set resume offsets of pushed batches.
+    void setStartOffset(qint64 in_offset);
+
 public slots:
-    //! Reads a file with the specified name by lines or chunks and processes obtained chunks - counts words.
+    //! Reads a file with the specified name by chunks and processes obtained chunks - counts words.
+    //! The file encoding is detected by the byte order mark: UTF-8, UTF-16 or Latin-1 if the text isn't valid UTF-8.
     void process(const QString& fileName);
 
-    //! Stops file processing. This method is thread safe.
+    //! Reads the file from the given offset as process() does after setStartOffset(). It's connected to CTextAnalyzerWorker::resumed(),
+    //! so the file is read from the offset, which the text analyzer has restored in its own thread.
+    void processFrom(const QString& in_fileName, qint64 in_startOffset);
+
+    //! Stops file processing. This method is thread safe. Following of the file finishes its processing.
     void stopProcessing();
 
-signals:
-    void chunkProcessed(const WordsMap&);
+private slots:
+    //! Reads data appended to the followed file since the previous reading.
+    void readAppendedData();
 
+signals:
     //! Status from the CommonData::EFileReadingStatus enumeration.
     void statusChanged(int);
 
+    //! The hash of the file's content calculated by CContentHasher while the file is read, so the result cache doesn't read the file again.
+    //! It's emitted before the status of finished processing unless reading has been resumed or the file has been followed.
+    void contentHashCalculated(quint64 contentHash);
+
 private:
-    //! Splits the given string to individual words divided by whitespace characters and counts words in the given string.
-    //! @param inout_remainder [in, out] - If the line length is greater than the maximum chunk size, then the first and last words in the chunk could be divided into parts.
-    //!                                    It's necessary to merge word head (the last word) from the previous chunk with word tail (the first word) from the current chunk.
-    void processChunk(const QString& in_chunk, qint64 in_maxChunkSize, QString& inout_remainder, WordsMap& inout_words);
+    //! Starts following of the file, reads its current data and watches it.
+    void startFollowing(const QString& in_fileName);
+
+    //! Reads the open followed file from the read offset to its end. The handle is used, so a rotated file is read after it's renamed.
+    //! @return false if the words batch queue has been aborted.
+    bool readFollowedData();
+
+    //! Stops watching of the followed file, counts the last word and closes the words batch queue.
+    void finishFollowing();
+
+    //! Checks if the followed file name refers to another file than the open one, e.g. after rotation.
+    bool isFollowedFileReplaced() const;
+
+    //! Reads the file by chunks. It's used for pipes and other non-mappable inputs.
+    //! @return false if file processing has been interrupted.
+    bool processStream(QFile& inout_file);
+
+    //! Splits the mapped file data to individual words divided by whitespace and punctuation characters and counts words.
+    //! UTF-8 words are taken straight out of the mapped pages, so lines of any length are processed without copying.
+    //! @param in_fileOffset [in] - the offset of the data in the file.
+    //! @return false if file processing has been interrupted.
+    bool processMappedData(const char* in_data, qint64 in_size, qint64 in_fileOffset, CommonData::ETextEncoding in_encoding);
+
+    //! Divides the mapped UTF-8 file data into byte ranges aligned to words' boundaries, counts words of the ranges in the thread pool
+    //! and merges the ranges' words in the file order.
+    //! @param in_fileOffset [in] - the offset of the data in the file.
+    //! @return false if file processing has been interrupted.
+    bool processMappedDataInParallel(const char* in_data, qint64 in_size, qint64 in_fileOffset);
+
+    //! Splits the given chunk of text in the transcoder's encoding to individual words and counts them.
+    void processData(const char* in_data, qint64 in_size);
+
+    //! Counts the word pending in the tokenizer. The text must be at a word's boundary.
+    void finishWord();
+
+    //! Counts the last word of the text and pushes the remaining words.
+    //! @return false if the words batch queue has been aborted.
+    bool finishData();
+
+    //! Passes the filled words batch to the text analyzer and takes a free one. Waits while the text analyzer processes all batches.
+    //! @return false if the words batch queue has been aborted.
+    bool pushBatch();
 
-    WordsMap m_words;
+    CWordTokenizer m_tokenizer;
+    CUtf8Transcoder m_transcoder;
+    CContentHasher m_contentHasher;
+    QByteArray m_utf8Chunk;                 //!< The chunk converted to UTF-8.
+    QByteArray m_lowerCaseWord;             //!< The buffer with reserved capacity for lowercase words.
+    QSharedPointer<CWordsBatchQueue> m_wordsBatchQueue;
+    QSharedPointer<CPipelineMetrics> m_pipelineMetrics;
+    std::unique_ptr<CWordsBatch> m_batch;                       //!< The batch being filled.
+    std::vector<std::unique_ptr<CWordsBatch>> m_rangeBatches;   //!< Batches of byte ranges in the CommonData::efrmParallel mode.
+    CommonData::EFileReadingMode m_readingMode { CommonData::efrmMemoryMapped };
+    qint64 m_startOffset { 0 };
+    bool m_isFollowMode { false };
+    QString m_followedFileName;
+    QFile m_followedFile;
+    qint64 m_followedOffset { 0 };          //!< The size of the followed file's data, which has been read.
+    QFileSystemWatcher m_fileSystemWatcher; //!< Watches the followed file and its directory, where a rotated file is created again.
+    QThreadPool m_threadPool;
     QAtomicInteger<bool> m_isStop { false };
 };
 
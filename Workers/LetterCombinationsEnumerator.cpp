@@ -0,0 +1,35 @@
+#include "LetterCombinationsEnumerator.h"
+#include "StringInterner.h"
+#include "TextEncoding.h"
+
+#include <algorithm>
+
+void CLetterCombinationsEnumerator::enumerate(const char* in_word, int in_size, int in_minLength, int in_maxLength)
+{
+    // Letter combinations' length is measured in characters, so find characters' offsets in the UTF-8 word.
+    m_characterOffsets.clear();
+    for (int i = 0; i < in_size; ++i) {
+        if (TextEncoding::IsCharacterBegin(in_word[i])) {
+            m_characterOffsets.push_back(i);
+        }
+    }
+    m_characterOffsets.push_back(in_size);
+
+    // Hashes of all letter combinations beginning at the same character are calculated in one pass: the hash of the shortest
+    // combination is extended by the bytes of the following characters.
+    m_letterCombinations.clear();
+    const int charactersCount = static_cast<int>(m_characterOffsets.size()) - 1;
+    for (int i = 0; i + in_minLength <= charactersCount; ++i) {
+        const int offset = m_characterOffsets[i];
+        quint64 hash = CStringInterner::HashOffsetBasis;
+        int end = offset;
+        const int maxLength = std::min(charactersCount - i, in_maxLength);
+        for (int length = in_minLength; length <= maxLength; ++length) {
+            const int combinationEnd = m_characterOffsets[i + length];
+            for (; end < combinationEnd; ++end) {
+                hash = CStringInterner::extendHash(hash, static_cast<uchar>(in_word[end]));
+            }
+            m_letterCombinations.push_back({ hash, offset, combinationEnd - offset });
+        }
+    }
+}
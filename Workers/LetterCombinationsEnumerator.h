@@ -0,0 +1,34 @@
+#ifndef LETTERCOMBINATIONSENUMERATOR_H
+#define LETTERCOMBINATIONSENUMERATOR_H
+
+#include "CommonData.h"
+
+#include <vector>
+
+//! The CLetterCombinationsEnumerator class finds all letter combinations of a word as views into the word with their hashes.
+//! Buffers are reused between words, so enumeration doesn't allocate memory once they have grown to the longest word.
+class CLetterCombinationsEnumerator
+{
+public:
+    //! The letter combination of the enumerated word.
+    struct SLetterCombination
+    {
+        quint64 hash;   //!< The hash calculated by CStringInterner::hash().
+        int offset;     //!< The offset in the word in bytes.
+        int size;       //!< The size in bytes.
+    };
+
+    //! Finds all letter combinations of the given UTF-8 word, which lengths are in the given range.
+    //! Letter combinations' length is measured in characters. Repeated combinations are stored as many times as they occur.
+    void enumerate(const char* in_word, int in_size, int in_minLength = CommonData::MinLetterCombinationLength,
+                   int in_maxLength = CommonData::MaxLetterCombinationLength);
+
+    //! Returns letter combinations of the last enumerated word.
+    const std::vector<SLetterCombination>& letterCombinations() const { return m_letterCombinations; }
+
+private:
+    std::vector<int> m_characterOffsets;                    //!< Characters' offsets in the word and the word size at the end.
+    std::vector<SLetterCombination> m_letterCombinations;
+};
+
+#endif // LETTERCOMBINATIONSENUMERATOR_H
@@ -0,0 +1,59 @@
+#include "PackedLetterCombinationsIndex.h"
+
+#include <algorithm>
+
+namespace {
+
+    constexpr int InitialTableSizeLog = 12;
+
+} // namespace
+
+CPackedLetterCombinationsIndex::CPackedLetterCombinationsIndex()
+    : m_keys(static_cast<size_t>(1) << InitialTableSizeLog, 0)
+    , m_ids(static_cast<size_t>(1) << InitialTableSizeLog, InvalidId)
+    , m_shift(64 - InitialTableSizeLog)
+{}
+
+void CPackedLetterCombinationsIndex::insert(quint64 in_key, quint32 in_id)
+{
+    Q_ASSERT(in_key);
+    const size_t mask = m_keys.size() - 1;
+    size_t slot = slotOf(in_key);
+    while (m_keys[slot]) {
+        slot = (slot + 1) & mask;
+    }
+    m_keys[slot] = in_key;
+    m_ids[slot] = in_id;
+
+    // Keep the load factor below one half.
+    if (++m_size * 2 > m_keys.size()) {
+        grow();
+    }
+}
+
+void CPackedLetterCombinationsIndex::clear()
+{
+    std::fill(std::begin(m_keys), std::end(m_keys), 0);
+    m_size = 0;
+}
+
+void CPackedLetterCombinationsIndex::grow()
+{
+    std::vector<quint64> keys(m_keys.size() * 2, 0);
+    std::vector<quint32> ids(m_ids.size() * 2, InvalidId);
+    std::swap(keys, m_keys);
+    std::swap(ids, m_ids);
+    --m_shift;
+
+    const size_t mask = m_keys.size() - 1;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (keys[i]) {
+            size_t slot = slotOf(keys[i]);
+            while (m_keys[slot]) {
+                slot = (slot + 1) & mask;
+            }
+            m_keys[slot] = keys[i];
+            m_ids[slot] = ids[i];
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef PACKEDLETTERCOMBINATIONSINDEX_H
+#define PACKEDLETTERCOMBINATIONSINDEX_H
+
+#include <QtGlobal>
+
+#include <vector>
+
+//! The CPackedLetterCombinationsIndex class maps short ASCII letter combinations packed into 64-bit integers to identifiers in the dictionary.
+//! A letter combination of up to MaxLength bytes is packed 8 bits per byte, so different combinations of non-zero bytes never share a key,
+//! and lookups need neither string hashing nor string comparison.
+class CPackedLetterCombinationsIndex
+{
+public:
+    static constexpr int MaxLength = 8;
+    static constexpr quint32 InvalidId = 0xFFFFFFFF;
+
+    //! Packs the letter combination of the given length. Its bytes must be non-zero.
+    template<int Length>
+    static quint64 pack(const char* in_data)
+    {
+        static_assert(Length > 0 && Length <= MaxLength, "The letter combination doesn't fit into the packed key.");
+        quint64 result = 0;
+        for (int i = 0; i < Length; ++i) {
+            result = (result << 8) | static_cast<uchar>(in_data[i]);
+        }
+        return result;
+    }
+
+    //! Packs the letter combination of the given size, which mustn't exceed MaxLength. Its bytes must be non-zero.
+    static quint64 pack(const char* in_data, int in_size)
+    {
+        quint64 result = 0;
+        for (int i = 0; i < in_size; ++i) {
+            result = (result << 8) | static_cast<uchar>(in_data[i]);
+        }
+        return result;
+    }
+
+    //! Returns the key of the next letter combination of the same length, which is shifted by one byte.
+    template<int Length>
+    static quint64 shift(quint64 in_key, char in_nextByte)
+    {
+        constexpr quint64 Mask = Length == MaxLength ? ~0ULL : (1ULL << (8 * Length)) - 1;
+        return ((in_key << 8) | static_cast<uchar>(in_nextByte)) & Mask;
+    }
+
+    CPackedLetterCombinationsIndex();
+
+    //! Returns the identifier of the given key or InvalidId if it's missing.
+    quint32 find(quint64 in_key) const
+    {
+        const size_t mask = m_keys.size() - 1;
+        for (size_t slot = slotOf(in_key); ; slot = (slot + 1) & mask) {
+            if (m_keys[slot] == in_key) {
+                return m_ids[slot];
+            }
+            if (!m_keys[slot]) {
+                return InvalidId;
+            }
+        }
+    }
+
+    //! Adds the missing key with the given identifier.
+    void insert(quint64 in_key, quint32 in_id);
+
+    //! Removes all keys and keeps the allocated memory.
+    void clear();
+
+    //! Returns the approximate memory taken by the index in bytes.
+    size_t memoryUsage() const { return m_keys.size() * (sizeof(quint64) + sizeof(quint32)); }
+
+private:
+    //! Fibonacci hashing spreads keys, which differ in the low bytes only.
+    size_t slotOf(quint64 in_key) const { return static_cast<size_t>((in_key * 11400714819323198485ULL) >> m_shift); }
+    void grow();
+
+    std::vector<quint64> m_keys;    //!< Open addressing table of keys, zero marks an empty slot. Its size is a power of two.
+    std::vector<quint32> m_ids;     //!< Identifiers of keys in the same slots.
+    quint32 m_size { 0 };
+    int m_shift { 0 };              //!< 64 minus the binary logarithm of the table size.
+};
+
+#endif // PACKEDLETTERCOMBINATIONSINDEX_H
@@ -0,0 +1,105 @@
+#include "PipelineMetrics.h"
+
+#include <algorithm>
+
+QJsonObject CPipelineMetrics::SSample::toJson() const
+{
+    return {
+        { "elapsedTime", static_cast<double>(elapsedTime) },
+        { "fileSize", static_cast<double>(fileSize) },
+        { "fileOffset", static_cast<double>(fileOffset) },
+        { "bytesRead", static_cast<double>(bytesRead) },
+        { "bytesPerSecond", bytesPerSecond },
+        { "wordsProcessed", static_cast<double>(wordsProcessed) },
+        { "wordsPerSecond", wordsPerSecond },
+        { "queuedBatches", queuedBatchesCount },
+        { "dictionarySize", static_cast<double>(dictionarySize) },
+        { "cacheHitRate", cacheHitRate },
+        { "memoryUsage", static_cast<double>(memoryUsage) },
+        { "progress", progress },
+        { "remainingTime", static_cast<double>(remainingTime) }
+    };
+}
+
+CPipelineMetrics::CPipelineMetrics()
+{
+    m_timer.start();
+}
+
+void CPipelineMetrics::setWordsBatchQueue(const QSharedPointer<CWordsBatchQueue>& in_wordsBatchQueue)
+{
+    m_wordsBatchQueue = in_wordsBatchQueue;
+}
+
+void CPipelineMetrics::reset()
+{
+    m_fileSize.store(-1, std::memory_order_relaxed);
+    m_startOffset.store(0, std::memory_order_relaxed);
+    m_fileOffset.store(0, std::memory_order_relaxed);
+    m_wordsProcessed.store(0, std::memory_order_relaxed);
+    m_dictionarySize.store(0, std::memory_order_relaxed);
+    m_cacheHitsCount.store(0, std::memory_order_relaxed);
+    m_cacheMissesCount.store(0, std::memory_order_relaxed);
+    m_memoryUsage.store(0, std::memory_order_relaxed);
+    m_timer.restart();
+    m_previousTime = 0;
+    m_previousBytesRead = 0;
+    m_previousWordsProcessed = 0;
+}
+
+void CPipelineMetrics::startReading(qint64 in_fileSize, qint64 in_startOffset)
+{
+    m_fileSize.store(in_fileSize, std::memory_order_relaxed);
+    m_startOffset.store(in_startOffset, std::memory_order_relaxed);
+    m_fileOffset.store(in_startOffset, std::memory_order_relaxed);
+}
+
+void CPipelineMetrics::setAnalyzerState(quint64 in_wordsProcessed, quint64 in_dictionarySize, quint64 in_cacheHitsCount, quint64 in_cacheMissesCount,
+                                        quint64 in_memoryUsage)
+{
+    m_wordsProcessed.store(in_wordsProcessed, std::memory_order_relaxed);
+    m_dictionarySize.store(in_dictionarySize, std::memory_order_relaxed);
+    m_cacheHitsCount.store(in_cacheHitsCount, std::memory_order_relaxed);
+    m_cacheMissesCount.store(in_cacheMissesCount, std::memory_order_relaxed);
+    m_memoryUsage.store(in_memoryUsage, std::memory_order_relaxed);
+}
+
+CPipelineMetrics::SSample CPipelineMetrics::sample()
+{
+    SSample sample;
+    sample.elapsedTime = m_timer.elapsed();
+    sample.fileSize = m_fileSize.load(std::memory_order_relaxed);
+    sample.fileOffset = m_fileOffset.load(std::memory_order_relaxed);
+    // The offset goes back when a followed file is truncated.
+    sample.bytesRead = std::max(sample.fileOffset - m_startOffset.load(std::memory_order_relaxed), qint64(0));
+    sample.wordsProcessed = m_wordsProcessed.load(std::memory_order_relaxed);
+    sample.queuedBatchesCount = m_wordsBatchQueue ? m_wordsBatchQueue->queuedBatchesCount() : 0;
+    sample.dictionarySize = m_dictionarySize.load(std::memory_order_relaxed);
+    sample.memoryUsage = m_memoryUsage.load(std::memory_order_relaxed);
+
+    const quint64 cacheHitsCount = m_cacheHitsCount.load(std::memory_order_relaxed);
+    const quint64 cacheLookupsCount = cacheHitsCount + m_cacheMissesCount.load(std::memory_order_relaxed);
+    sample.cacheHitRate = cacheLookupsCount ? static_cast<double>(cacheHitsCount) / cacheLookupsCount : -1.0;
+
+    const qint64 interval = sample.elapsedTime - m_previousTime;
+    if (interval > 0) {
+        sample.bytesPerSecond = std::max(sample.bytesRead - m_previousBytesRead, qint64(0)) * 1000.0 / interval;
+        sample.wordsPerSecond = (sample.wordsProcessed >= m_previousWordsProcessed ? sample.wordsProcessed - m_previousWordsProcessed : 0) * 1000.0 / interval;
+        m_previousTime = sample.elapsedTime;
+        m_previousBytesRead = sample.bytesRead;
+        m_previousWordsProcessed = sample.wordsProcessed;
+    }
+
+    // The remaining time is estimated by the average rate, which is steadier than the rate since the previous sample.
+    if (sample.fileSize > 0) {
+        sample.progress = std::min(static_cast<double>(sample.fileOffset) / sample.fileSize, 1.0);
+        if (sample.bytesRead > 0 && sample.elapsedTime > 0) {
+            const qint64 remainingBytes = std::max(sample.fileSize - sample.fileOffset, qint64(0));
+            sample.remainingTime = static_cast<qint64>(static_cast<double>(remainingBytes) * sample.elapsedTime / sample.bytesRead);
+        }
+    } else if (!sample.fileSize) {
+        sample.progress = 1.0;
+        sample.remainingTime = 0;
+    }
+    return sample;
+}
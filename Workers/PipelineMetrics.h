@@ -0,0 +1,80 @@
+#ifndef PIPELINEMETRICS_H
+#define PIPELINEMETRICS_H
+
+#include "WordsBatchQueue.h"
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QSharedPointer>
+
+#include <atomic>
+
+//! The CPipelineMetrics class is the registry of live metrics of text analyzing. The file reader and the text analyzer publish their counters
+//! by relaxed atomic stores once per chunk or words batch, so the cost doesn't depend on the text. An observer samples the registry periodically
+//! and derives rates, the progress by the file offset and the estimated remaining time.
+class CPipelineMetrics
+{
+public:
+    //! The state of text analyzing at the moment of sampling.
+    struct SSample
+    {
+        qint64 elapsedTime { 0 };           //!< Milliseconds since the registry has been reset.
+        qint64 fileSize { -1 };             //!< The file size in bytes, -1 if it's unknown, e.g. for pipes.
+        qint64 fileOffset { 0 };            //!< The file offset, up to which text has been read.
+        qint64 bytesRead { 0 };             //!< Bytes read since the start. Bytes before the resume offset aren't counted.
+        double bytesPerSecond { 0.0 };      //!< The reading rate since the previous sample.
+        quint64 wordsProcessed { 0 };
+        double wordsPerSecond { 0.0 };      //!< The analyzing rate since the previous sample.
+        int queuedBatchesCount { 0 };       //!< Words batches waiting for the text analyzer.
+        quint64 dictionarySize { 0 };       //!< Distinct letter combinations in memory, see CTextAnalyzerWorker::dictionarySize().
+        double cacheHitRate { -1.0 };       //!< The share of words found in the cache of words' letter combinations, -1 if the cache isn't used.
+        quint64 memoryUsage { 0 };          //!< The estimated memory of counted letter combinations in bytes.
+        double progress { -1.0 };           //!< The read share of the file from 0 to 1, -1 if the file size is unknown.
+        qint64 remainingTime { -1 };        //!< The estimated time to read the rest of the file in milliseconds, -1 if it's unknown.
+
+        QJsonObject toJson() const;
+    };
+
+    CPipelineMetrics();
+
+    //! Sets the queue, which depth is sampled.
+    void setWordsBatchQueue(const QSharedPointer<CWordsBatchQueue>& in_wordsBatchQueue);
+
+    //! Clears all counters and restarts the time. It's called by the observer before the file reader starts, workers must not update the registry meanwhile.
+    void reset();
+
+    //! Publishes the size of the file and the offset, from which reading starts. It's called by the file reader. The size is unknown if it's negative.
+    void startReading(qint64 in_fileSize, qint64 in_startOffset);
+
+    //! Publishes the size of the followed file, which grows while it's read. It's called by the file reader.
+    void setFileSize(qint64 in_fileSize) { m_fileSize.store(in_fileSize, std::memory_order_relaxed); }
+
+    //! Publishes the file offset, up to which text has been read. It's called by the file reader.
+    void setFileOffset(qint64 in_fileOffset) { m_fileOffset.store(in_fileOffset, std::memory_order_relaxed); }
+
+    //! Publishes the state of the text analyzer. It's called by the text analyzer after every words batch.
+    void setAnalyzerState(quint64 in_wordsProcessed, quint64 in_dictionarySize, quint64 in_cacheHitsCount, quint64 in_cacheMissesCount,
+                          quint64 in_memoryUsage);
+
+    //! Takes the sample of the current state. It must be called by the observer's thread only, rates are calculated since its previous sample.
+    SSample sample();
+
+private:
+    QSharedPointer<CWordsBatchQueue> m_wordsBatchQueue;
+    std::atomic<qint64> m_fileSize { -1 };
+    std::atomic<qint64> m_startOffset { 0 };
+    std::atomic<qint64> m_fileOffset { 0 };
+    std::atomic<quint64> m_wordsProcessed { 0 };
+    std::atomic<quint64> m_dictionarySize { 0 };
+    std::atomic<quint64> m_cacheHitsCount { 0 };
+    std::atomic<quint64> m_cacheMissesCount { 0 };
+    std::atomic<quint64> m_memoryUsage { 0 };
+
+    // The state of the previous sample, which rates are calculated from. It's accessed by the observer only.
+    QElapsedTimer m_timer;
+    qint64 m_previousTime { 0 };
+    qint64 m_previousBytesRead { 0 };
+    quint64 m_previousWordsProcessed { 0 };
+};
+
+#endif // PIPELINEMETRICS_H
@@ -0,0 +1,214 @@
+#include "ResultCache.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+    const QString EntrySuffix { ".index" };
+
+    constexpr quint64 Prime1 = 0x9E3779B185EBCA87ULL;
+    constexpr quint64 Prime2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr quint64 Prime3 = 0x165667B19E3779F9ULL;
+
+    quint64 rotateLeft(quint64 in_value, int in_bits)
+    {
+        return (in_value << in_bits) | (in_value >> (64 - in_bits));
+    }
+
+    quint64 load(const uchar* in_data)
+    {
+        quint64 value = 0;
+        std::memcpy(&value, in_data, sizeof(value));
+        return value;
+    }
+
+    quint64 mix(quint64 in_lane, quint64 in_value)
+    {
+        return rotateLeft(in_lane + in_value * Prime2, 31) * Prime1;
+    }
+
+    void mixStripe(quint64* inout_lanes, const uchar* in_stripe)
+    {
+        for (int i = 0; i < 4; ++i) {
+            inout_lanes[i] = mix(inout_lanes[i], load(in_stripe + i * 8));
+        }
+    }
+
+} // namespace
+
+CContentHasher::CContentHasher()
+{
+    reset();
+}
+
+void CContentHasher::add(const char* in_data, qint64 in_size)
+{
+    const uchar* data = reinterpret_cast<const uchar*>(in_data);
+    const uchar* const end = data + in_size;
+    m_size += static_cast<quint64>(in_size);
+    if (m_stripeSize) {
+        const int size = static_cast<int>(std::min<qint64>(end - data, static_cast<qint64>(sizeof(m_stripe)) - m_stripeSize));
+        std::memcpy(m_stripe + m_stripeSize, data, static_cast<size_t>(size));
+        m_stripeSize += size;
+        data += size;
+        if (m_stripeSize < static_cast<int>(sizeof(m_stripe))) {
+            return;
+        }
+        mixStripe(m_lanes, m_stripe);
+        m_stripeSize = 0;
+    }
+    for (; end - data >= static_cast<qint64>(sizeof(m_stripe)); data += sizeof(m_stripe)) {
+        mixStripe(m_lanes, data);
+    }
+    m_stripeSize = static_cast<int>(end - data);
+    std::memcpy(m_stripe, data, static_cast<size_t>(m_stripeSize));
+}
+
+quint64 CContentHasher::result() const
+{
+    quint64 hash = rotateLeft(m_lanes[0], 1) + rotateLeft(m_lanes[1], 7) + rotateLeft(m_lanes[2], 12) + rotateLeft(m_lanes[3], 18);
+    hash += m_size;
+    const uchar* data = m_stripe;
+    const uchar* const end = m_stripe + m_stripeSize;
+    for (; end - data >= 8; data += 8) {
+        hash = rotateLeft(hash ^ mix(0, load(data)), 27) * Prime1 + Prime3;
+    }
+    for (; data != end; ++data) {
+        hash = rotateLeft(hash ^ (*data * Prime3), 11) * Prime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= Prime2;
+    hash ^= hash >> 29;
+    hash *= Prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+void CContentHasher::reset()
+{
+    m_lanes[0] = Prime1 + Prime2;
+    m_lanes[1] = Prime2;
+    m_lanes[2] = 0;
+    m_lanes[3] = 0 - Prime1;
+    m_stripeSize = 0;
+    m_size = 0;
+}
+
+QString CResultCache::DefaultDirectory()
+{
+    const QString cacheLocation = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    return QDir(cacheLocation.isEmpty() ? QDir(QDir::tempPath()).filePath("TextAnalyzer") : cacheLocation).filePath("Results");
+}
+
+QString CResultCache::KeyPrefix(const QString& in_fileName, int in_minLetterCombinationLength, int in_maxLetterCombinationLength)
+{
+    const QFileInfo fileInfo(in_fileName);
+    if (!fileInfo.exists()) {
+        return QString();
+    }
+    return QString("%1-%2-%3-%4").arg(fileInfo.size()).arg(fileInfo.lastModified().toMSecsSinceEpoch())
+            .arg(in_minLetterCombinationLength).arg(in_maxLetterCombinationLength);
+}
+
+QString CResultCache::Key(const QString& in_keyPrefix, quint64 in_contentHash)
+{
+    return QString("%1-%2").arg(in_keyPrefix).arg(in_contentHash, 16, 16, QChar('0'));
+}
+
+QString CResultCache::Key(const QString& in_fileName, int in_minLetterCombinationLength, int in_maxLetterCombinationLength)
+{
+    QFile file(in_fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+
+    const qint64 size = file.size();
+    CContentHasher contentHasher;
+    if (size > 0) {
+        uchar* data = file.map(0, size);
+        if (!data) {
+            return QString();
+        }
+        contentHasher.add(reinterpret_cast<const char*>(data), size);
+        file.unmap(data);
+    }
+    return Key(KeyPrefix(in_fileName, in_minLetterCombinationLength, in_maxLetterCombinationLength), contentHasher.result());
+}
+
+bool CResultCache::containsKeyPrefix(const QString& in_keyPrefix) const
+{
+    if (!isEnabled() || in_keyPrefix.isEmpty()) {
+        return false;
+    }
+    return !QDir(m_directory).entryList({ in_keyPrefix + "-*" + EntrySuffix }, QDir::Files).isEmpty();
+}
+
+CResultCache::CResultCache(const QString& in_directory, qint64 in_maxSize)
+    : m_directory(in_directory)
+{
+    setMaxSize(in_maxSize);
+}
+
+void CResultCache::setMaxSize(qint64 in_maxSize)
+{
+    m_maxSize = std::max(in_maxSize, static_cast<qint64>(0));
+}
+
+QString CResultCache::entryFileName(const QString& in_key) const
+{
+    if (!isEnabled() || in_key.isEmpty() || !QDir().mkpath(m_directory)) {
+        return QString();
+    }
+    return QDir(m_directory).filePath(in_key + EntrySuffix);
+}
+
+bool CResultCache::find(const QString& in_key, CResultIndex& out_resultIndex) const
+{
+    out_resultIndex.close();
+    if (!isEnabled() || in_key.isEmpty()) {
+        return false;
+    }
+
+    const QString fileName = QDir(m_directory).filePath(in_key + EntrySuffix);
+    QFile file(fileName);
+    if (!file.exists()) {
+        return false;
+    }
+    if (!out_resultIndex.open(fileName)) {
+        file.remove();
+        return false;
+    }
+
+    // The modification time of the entry is its last use.
+    if (file.open(QIODevice::ReadWrite)) {
+        file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
+    return true;
+}
+
+void CResultCache::evict() const
+{
+    QDir directory(m_directory);
+    if (!directory.exists()) {
+        return;
+    }
+
+    // Entries are listed from the most recently used.
+    const QFileInfoList entries = directory.entryInfoList({ "*" + EntrySuffix }, QDir::Files, QDir::Time);
+    qint64 size = 0;
+    for (const auto& entry : entries) {
+        if (size + entry.size() > m_maxSize) {
+            QFile::remove(entry.absoluteFilePath());
+        } else {
+            size += entry.size();
+        }
+    }
+}
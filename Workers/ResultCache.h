@@ -0,0 +1,83 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include "ResultIndex.h"
+
+#include <QString>
+
+//! The CContentHasher class hashes the file's content by 32-byte stripes in four independent lanes, so the hashing runs at memory speed
+//! rather than byte by byte. The content may be added by chunks of any size, e.g. while the file is read. The hash isn't cryptographic:
+//! it only tells changed files apart.
+class CContentHasher
+{
+public:
+    CContentHasher();
+
+    void add(const char* in_data, qint64 in_size);
+
+    //! Returns the hash of the content added since the last reset.
+    quint64 result() const;
+    void reset();
+
+private:
+    quint64 m_lanes[4];
+    uchar m_stripe[32];         //!< The incomplete stripe.
+    int m_stripeSize { 0 };
+    quint64 m_size { 0 };
+};
+
+//! The CResultCache class keeps result indexes of analyzed files in the cache directory, so a repeated analysis of an unchanged file
+//! is answered from its index. An entry is keyed by the file's size, modification time and the hash of its content, so a renamed copy
+//! of the file hits the same entry, while any change of the file misses it. The directory is bounded by its size:
+//! when it's exceeded, the least recently used entries are removed.
+class CResultCache
+{
+public:
+    static constexpr qint64 DefaultMaxSize = 1024LL * 1024 * 1024;
+
+    //! Returns the cache directory of the application's results.
+    static QString DefaultDirectory();
+
+    //! Returns the part of the file's key, which doesn't depend on the content: the size, the modification time and the letter combinations'
+    //! lengths range, which results are counted with. The number of the top letter combinations isn't a part of the key,
+    //! because the index contains all letter combinations, so the top of any size is read from it.
+    //! @return an empty string if the file doesn't exist.
+    static QString KeyPrefix(const QString& in_fileName, int in_minLetterCombinationLength = CommonData::MinLetterCombinationLength,
+                             int in_maxLetterCombinationLength = CommonData::MaxLetterCombinationLength);
+
+    //! Returns the key of the file's entry by its prefix and the content hash calculated by CContentHasher, e.g. while the file is analyzed.
+    static QString Key(const QString& in_keyPrefix, quint64 in_contentHash);
+
+    //! Returns the key of the file's entry. The content is hashed in one streaming pass over the mapped file.
+    //! @return an empty string if the file couldn't be read.
+    static QString Key(const QString& in_fileName, int in_minLetterCombinationLength = CommonData::MinLetterCombinationLength,
+                       int in_maxLetterCombinationLength = CommonData::MaxLetterCombinationLength);
+
+    explicit CResultCache(const QString& in_directory = DefaultDirectory(), qint64 in_maxSize = DefaultMaxSize);
+
+    //! Sets the maximum size of the cache directory in bytes. Zero size disables the cache.
+    void setMaxSize(qint64 in_maxSize);
+    qint64 maxSize() const { return m_maxSize; }
+    bool isEnabled() const { return m_maxSize > 0; }
+
+    //! Returns the file name of the key's entry, which the result index is written to. The directory is created if it's missing.
+    //! @return an empty string if the cache is disabled or the directory couldn't be created.
+    QString entryFileName(const QString& in_key) const;
+
+    //! Checks if there are entries with the given key prefix. The file isn't hashed unless there is an entry of a file with the same size
+    //! and modification time, so the first analysis of the file isn't delayed by hashing.
+    bool containsKeyPrefix(const QString& in_keyPrefix) const;
+
+    //! Opens the result index of the key's entry and marks the entry as recently used.
+    //! @return false if the entry is missing or invalid, the invalid entry is removed.
+    bool find(const QString& in_key, CResultIndex& out_resultIndex) const;
+
+    //! Removes the least recently used entries until the directory fits into the maximum size.
+    void evict() const;
+
+private:
+    QString m_directory;
+    qint64 m_maxSize { DefaultMaxSize };
+};
+
+#endif // RESULTCACHE_H
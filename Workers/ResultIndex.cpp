@@ -0,0 +1,255 @@
+#include "ResultIndex.h"
+
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+struct CResultIndex::SHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint64 entriesCount;
+    quint64 totalLetterCombinationsCount;
+    quint64 entriesOffset;      //!< Entries in count descending order.
+    quint64 keyOrderOffset;     //!< 32-bit indexes of entries in letter combinations' order.
+    quint64 stringsOffset;
+    quint64 stringsSize;
+    quint64 wordsProcessedCount;
+};
+
+struct CResultIndex::SEntry
+{
+    quint64 count;
+    quint64 stringOffset;       //!< The offset in the strings section.
+    quint32 stringSize;
+    quint32 reserved;
+};
+
+namespace {
+
+    qint64 alignedSize(qint64 in_size)
+    {
+        return (in_size + 7) & ~qint64(7);
+    }
+
+    bool isLess(const char* in_lhs, int in_lhsSize, const char* in_rhs, int in_rhsSize)
+    {
+        const int result = std::memcmp(in_lhs, in_rhs, static_cast<size_t>(std::min(in_lhsSize, in_rhsSize)));
+        return result ? result < 0 : in_lhsSize < in_rhsSize;
+    }
+
+} // namespace
+
+void CResultIndexWriter::add(const char* in_data, int in_size, quint64 in_count)
+{
+    m_strings.push_back(in_data);
+    m_sizes.push_back(in_size);
+    m_counts.push_back(in_count);
+    m_stringsSize += static_cast<quint64>(in_size);
+}
+
+bool CResultIndexWriter::write(const QString& in_fileName, quint64 in_totalLetterCombinationsCount, quint64 in_wordsProcessedCount) const
+{
+    using SHeader = CResultIndex::SHeader;
+    using SEntry = CResultIndex::SEntry;
+
+    auto isLessKey = [this](size_t lhs, size_t rhs){
+        return isLess(m_strings[lhs], m_sizes[lhs], m_strings[rhs], m_sizes[rhs]);
+    };
+    std::vector<quint32> byCount(m_counts.size());
+    std::iota(std::begin(byCount), std::end(byCount), 0);
+    std::sort(std::begin(byCount), std::end(byCount), [this, &isLessKey](quint32 lhs, quint32 rhs){
+        return m_counts[lhs] != m_counts[rhs] ? m_counts[lhs] > m_counts[rhs] : isLessKey(lhs, rhs);
+    });
+
+    // The key order refers to positions of entries in count descending order.
+    std::vector<quint32> byKey(byCount.size());
+    std::iota(std::begin(byKey), std::end(byKey), 0);
+    std::sort(std::begin(byKey), std::end(byKey), [&byCount, &isLessKey](quint32 lhs, quint32 rhs){
+        return isLessKey(byCount[lhs], byCount[rhs]);
+    });
+
+    const quint64 entriesCount = byCount.size();
+    SHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = qToLittleEndian(CResultIndex::Magic);
+    header.version = qToLittleEndian(CResultIndex::Version);
+    header.entriesCount = qToLittleEndian(entriesCount);
+    header.totalLetterCombinationsCount = qToLittleEndian(in_totalLetterCombinationsCount);
+    const qint64 entriesOffset = alignedSize(sizeof(SHeader));
+    const qint64 keyOrderOffset = entriesOffset + static_cast<qint64>(entriesCount * sizeof(SEntry));
+    const qint64 stringsOffset = alignedSize(keyOrderOffset + static_cast<qint64>(entriesCount * sizeof(quint32)));
+    header.entriesOffset = qToLittleEndian(static_cast<quint64>(entriesOffset));
+    header.keyOrderOffset = qToLittleEndian(static_cast<quint64>(keyOrderOffset));
+    header.stringsOffset = qToLittleEndian(static_cast<quint64>(stringsOffset));
+    header.stringsSize = qToLittleEndian(m_stringsSize);
+    header.wordsProcessedCount = qToLittleEndian(in_wordsProcessedCount);
+
+    QSaveFile file(in_fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(QByteArray(static_cast<int>(entriesOffset - sizeof(header)), '\0'));
+
+    // Strings are written in count descending order, so the top is read from one contiguous range.
+    std::vector<quint64> stringOffsets(entriesCount);
+    quint64 stringOffset = 0;
+    for (size_t i = 0; i < entriesCount; ++i) {
+        const quint32 id = byCount[i];
+        SEntry entry;
+        entry.count = qToLittleEndian(m_counts[id]);
+        entry.stringOffset = qToLittleEndian(stringOffset);
+        entry.stringSize = qToLittleEndian(static_cast<quint32>(m_sizes[id]));
+        entry.reserved = 0;
+        file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        stringOffset += static_cast<quint64>(m_sizes[id]);
+    }
+    for (const auto position : byKey) {
+        const quint32 littleEndianPosition = qToLittleEndian(position);
+        file.write(reinterpret_cast<const char*>(&littleEndianPosition), sizeof(littleEndianPosition));
+    }
+    file.write(QByteArray(static_cast<int>(stringsOffset - keyOrderOffset - static_cast<qint64>(entriesCount * sizeof(quint32))), '\0'));
+    for (const auto id : byCount) {
+        file.write(m_strings[id], m_sizes[id]);
+    }
+    return file.commit();
+}
+
+CResultIndex::CResultIndex() {}
+
+CResultIndex::~CResultIndex()
+{
+    close();
+}
+
+bool CResultIndex::open(const QString& in_fileName)
+{
+    static_assert(sizeof(SHeader) == 64 && sizeof(SEntry) == 24, "The index layout mustn't depend on the compiler.");
+
+    close();
+    m_file.setFileName(in_fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const qint64 fileSize = m_file.size();
+    if (fileSize < static_cast<qint64>(sizeof(SHeader))) {
+        m_file.close();
+        return false;
+    }
+    m_data = m_file.map(0, fileSize);
+    if (!m_data) {
+        m_file.close();
+        return false;
+    }
+
+    // Sections must be inside the file. Their contents aren't read, so queries check positions and strings' offsets.
+    const SHeader* indexHeader = header();
+    const quint64 entriesCount = qFromLittleEndian(indexHeader->entriesCount);
+    const quint64 entriesOffset = qFromLittleEndian(indexHeader->entriesOffset);
+    const quint64 keyOrderOffset = qFromLittleEndian(indexHeader->keyOrderOffset);
+    const quint64 stringsOffset = qFromLittleEndian(indexHeader->stringsOffset);
+    const quint64 stringsSize = qFromLittleEndian(indexHeader->stringsSize);
+    const quint64 size = static_cast<quint64>(fileSize);
+    const bool isValid = qFromLittleEndian(indexHeader->magic) == Magic && qFromLittleEndian(indexHeader->version) == Version
+            && entriesCount <= 0xFFFFFFFF && !(entriesOffset % 8) && !(keyOrderOffset % 4)
+            && entriesOffset <= size && entriesCount * sizeof(SEntry) <= size - entriesOffset
+            && keyOrderOffset <= size && entriesCount * sizeof(quint32) <= size - keyOrderOffset
+            && stringsOffset <= size && stringsSize <= size - stringsOffset;
+    if (!isValid) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void CResultIndex::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+        m_data = nullptr;
+    }
+    m_file.close();
+}
+
+quint64 CResultIndex::size() const
+{
+    return m_data ? qFromLittleEndian(header()->entriesCount) : 0;
+}
+
+quint64 CResultIndex::totalLetterCombinationsCount() const
+{
+    return m_data ? qFromLittleEndian(header()->totalLetterCombinationsCount) : 0;
+}
+
+quint64 CResultIndex::wordsProcessedCount() const
+{
+    return m_data ? qFromLittleEndian(header()->wordsProcessedCount) : 0;
+}
+
+quint64 CResultIndex::count(const QByteArray& in_letterCombination) const
+{
+    if (!m_data) {
+        return 0;
+    }
+
+    // Positions of the key order aren't validated by open(), so a position beyond the entries is taken as the empty letter combination.
+    // The search in a corrupted index gives a wrong count, but never reads outside the mapped file.
+    const quint32* order = keyOrder();
+    const quint32* it = std::lower_bound(order, order + size(), in_letterCombination, [this](quint32 position, const QByteArray& key){
+        const SEntry* indexEntry = entry(qFromLittleEndian(position));
+        const QByteArray entryLetterCombination = indexEntry ? letterCombination(*indexEntry) : QByteArray();
+        return isLess(entryLetterCombination.constData(), entryLetterCombination.size(), key.constData(), key.size());
+    });
+    if (it == order + size()) {
+        return 0;
+    }
+    const SEntry* indexEntry = entry(qFromLittleEndian(*it));
+    return indexEntry && letterCombination(*indexEntry) == in_letterCombination ? qFromLittleEndian(indexEntry->count) : 0;
+}
+
+WordsVector CResultIndex::top(int in_count) const
+{
+    WordsVector result;
+    const quint64 count = std::min(size(), static_cast<quint64>(std::max(in_count, 0)));
+    const SEntry* indexEntries = entries();
+    for (quint64 i = 0; i < count; ++i) {
+        result.push_back(QPair(QString::fromUtf8(letterCombination(indexEntries[i])), qFromLittleEndian(indexEntries[i].count)));
+    }
+    return result;
+}
+
+const CResultIndex::SHeader* CResultIndex::header() const
+{
+    return reinterpret_cast<const SHeader*>(m_data);
+}
+
+const CResultIndex::SEntry* CResultIndex::entries() const
+{
+    return reinterpret_cast<const SEntry*>(m_data + qFromLittleEndian(header()->entriesOffset));
+}
+
+const CResultIndex::SEntry* CResultIndex::entry(quint64 in_position) const
+{
+    return in_position < size() ? entries() + in_position : nullptr;
+}
+
+const quint32* CResultIndex::keyOrder() const
+{
+    return reinterpret_cast<const quint32*>(m_data + qFromLittleEndian(header()->keyOrderOffset));
+}
+
+QByteArray CResultIndex::letterCombination(const SEntry& in_entry) const
+{
+    // The string is used in place without copying. Entries aren't validated by open(), so the string is bounded by the strings section
+    // and by the maximum size of QByteArray.
+    const quint64 stringsSize = qFromLittleEndian(header()->stringsSize);
+    const quint64 offset = std::min(qFromLittleEndian(in_entry.stringOffset), stringsSize);
+    const quint64 size = std::min({ static_cast<quint64>(qFromLittleEndian(in_entry.stringSize)), stringsSize - offset,
+                                    static_cast<quint64>(std::numeric_limits<int>::max()) });
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(m_data + qFromLittleEndian(header()->stringsOffset) + offset), static_cast<int>(size));
+}
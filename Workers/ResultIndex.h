@@ -0,0 +1,80 @@
+#ifndef RESULTINDEX_H
+#define RESULTINDEX_H
+
+#include "CommonData.h"
+
+#include <QFile>
+#include <QByteArray>
+
+#include <vector>
+
+//! The CResultIndexWriter class writes the final dictionary of text analyzing as a binary result index, which is read by CResultIndex.
+//! The index consists of the header, letter combinations' entries in count descending order, entries' indexes in letter combinations' order
+//! and letter combinations' strings. Numbers are little-endian and aligned, so the mapped file is used as is.
+class CResultIndexWriter
+{
+public:
+    //! Adds the letter combination with its count. Letter combinations must be distinct. The letter combination isn't copied,
+    //! so the index doesn't double the memory of the dictionary, it must stay valid until the index is written.
+    void add(const char* in_data, int in_size, quint64 in_count);
+
+    //! Writes the index atomically.
+    //! @return false if the index couldn't be written.
+    bool write(const QString& in_fileName, quint64 in_totalLetterCombinationsCount, quint64 in_wordsProcessedCount) const;
+
+private:
+    std::vector<const char*> m_strings;     //!< Letter combinations owned by the caller.
+    std::vector<int> m_sizes;
+    std::vector<quint64> m_counts;
+    quint64 m_stringsSize { 0 };
+};
+
+//! The CResultIndex class maps the result index into memory and answers queries without re-analysis. Opening doesn't depend on the index size:
+//! only the header is validated, so queries bound positions and strings read from the file, and a corrupted index gives wrong results only.
+//! The count of a letter combination is found by binary search, the top of any size is the beginning of the entries.
+class CResultIndex
+{
+public:
+    static constexpr quint32 Magic = 0x58494154;    // "TAIX"
+    static constexpr quint32 Version = 2;           // The second version stores the number of processed words.
+
+    CResultIndex();
+    ~CResultIndex();
+
+    //! Maps the index file into memory.
+    //! @return false if the file couldn't be mapped or it isn't a valid index of the supported version.
+    bool open(const QString& in_fileName);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+
+    //! Returns the number of distinct letter combinations.
+    quint64 size() const;
+    quint64 totalLetterCombinationsCount() const;
+    quint64 wordsProcessedCount() const;
+
+    //! Returns the count of the given UTF-8 letter combination or zero if it's missing.
+    quint64 count(const QByteArray& in_letterCombination) const;
+
+    //! Returns the given number of the most common letter combinations in count descending order. Equal counts are ordered by letter combinations.
+    WordsVector top(int in_count) const;
+
+private:
+    friend class CResultIndexWriter;
+
+    struct SHeader;
+    struct SEntry;
+
+    const SHeader* header() const;
+    const SEntry* entries() const;
+
+    //! Returns the entry at the given position in count descending order or nullptr if it's beyond the entries.
+    const SEntry* entry(quint64 in_position) const;
+
+    const quint32* keyOrder() const;
+    QByteArray letterCombination(const SEntry& in_entry) const;
+
+    QFile m_file;
+    const uchar* m_data { nullptr };
+};
+
+#endif // RESULTINDEX_H
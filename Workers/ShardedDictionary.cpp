@@ -0,0 +1,176 @@
+#include "ShardedDictionary.h"
+#include "TextEncoding.h"
+#include "Tracing.h"
+#include "AllocationProfiler.h"
+
+#include <QFuture>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+CShardedDictionary::CShardedDictionary(int in_shardsCount)
+{
+    setShardsCount(in_shardsCount);
+}
+
+CShardedDictionary::~CShardedDictionary() {}
+
+void CShardedDictionary::setShardsCount(int in_shardsCount)
+{
+    const int shardsCount = std::max(in_shardsCount, 1);
+    m_shards.clear();
+    for (int i = 0; i < shardsCount; ++i) {
+        m_shards.push_back(std::make_unique<SShard>(m_topLetterCombinationsCount));
+    }
+    m_enumerators.assign(shardsCount, CLetterCombinationsEnumerator());
+    m_inboxes.assign(shardsCount * shardsCount, std::vector<SUpdate>());
+    m_slicesLetterCombinationsCounts.assign(shardsCount, 0);
+    m_threadPool.setMaxThreadCount(shardsCount);
+}
+
+void CShardedDictionary::setLetterCombinationsLengthRange(int in_minLength, int in_maxLength)
+{
+    m_minLetterCombinationLength = in_minLength;
+    m_maxLetterCombinationLength = in_maxLength;
+}
+
+void CShardedDictionary::setTopLetterCombinationsCount(int in_count)
+{
+    m_topLetterCombinationsCount = in_count;
+    clear();
+    for (auto& shard : m_shards) {
+        shard->top.setCapacity(in_count);
+    }
+}
+
+bool CShardedDictionary::addWords(const CWordsBatch& in_words, quint64& inout_totalLetterCombinationsCount)
+{
+    const int shardsCount = static_cast<int>(m_shards.size());
+    QVector<QFuture<void>> futures;
+    for (int slice = 0; slice < shardsCount; ++slice) {
+        futures.push_back(QtConcurrent::run(&m_threadPool, [this, &in_words, slice](){ routeSlice(in_words, slice); }));
+    }
+    for (auto& future : futures) {
+        future.waitForFinished();
+    }
+
+    futures.clear();
+    for (int shard = 0; shard < shardsCount; ++shard) {
+        futures.push_back(QtConcurrent::run(&m_threadPool, [this, shard](){ countShard(shard); }));
+    }
+    for (auto& future : futures) {
+        future.waitForFinished();
+    }
+
+    bool isTopChanged = false;
+    for (int i = 0; i < shardsCount; ++i) {
+        inout_totalLetterCombinationsCount += m_slicesLetterCombinationsCounts[i];
+        isTopChanged = isTopChanged || m_shards[i]->isTopChanged;
+    }
+    return isTopChanged;
+}
+
+WordsVector CShardedDictionary::top(int in_count) const
+{
+    std::vector<QPair<QByteArray, quint64>> letterCombinations;
+    for (const auto& shard : m_shards) {
+        for (const auto id : shard->top.ids()) {
+            letterCombinations.push_back({ QByteArray(shard->dictionary.data(id), shard->dictionary.size(id)), shard->counts[id] });
+        }
+    }
+    std::sort(std::begin(letterCombinations), std::end(letterCombinations), [](const auto& lhs, const auto& rhs){
+        return lhs.second != rhs.second ? lhs.second > rhs.second : lhs.first < rhs.first;
+    });
+
+    WordsVector result;
+    const int count = std::min(in_count, static_cast<int>(letterCombinations.size()));
+    for (int i = 0; i < count; ++i) {
+        result.push_back(QPair(QString::fromUtf8(letterCombinations[i].first), letterCombinations[i].second));
+    }
+    return result;
+}
+
+quint64 CShardedDictionary::size() const
+{
+    quint64 size = 0;
+    for (const auto& shard : m_shards) {
+        size += shard->dictionary.size();
+    }
+    return size;
+}
+
+size_t CShardedDictionary::memoryUsage() const
+{
+    size_t memoryUsage = 0;
+    for (const auto& shard : m_shards) {
+        memoryUsage += shard->dictionary.memoryUsage() + shard->counts.size() * sizeof(quint64);
+    }
+    return memoryUsage;
+}
+
+void CShardedDictionary::clear()
+{
+    for (auto& shard : m_shards) {
+        shard->dictionary.clear();
+        shard->counts.clear();
+        shard->top.clear();
+        shard->isTopChanged = false;
+    }
+}
+
+void CShardedDictionary::routeSlice(const CWordsBatch& in_words, int in_slice)
+{
+    const Tracing::CSpan span("ShardedDictionary::routeSlice");
+    const AllocationProfiler::CStageScope stage(AllocationProfiler::esEnumerator);
+    const int shardsCount = static_cast<int>(m_shards.size());
+    for (int shard = 0; shard < shardsCount; ++shard) {
+        m_inboxes[in_slice * shardsCount + shard].clear();
+    }
+
+    // Letter combinations are routed by the high bits of their hashes, the low bits are used by shards' dictionaries.
+    auto& enumerator = m_enumerators[in_slice];
+    quint64 letterCombinationsCount = 0;
+    const int wordsCount = in_words.size();
+    const int end = static_cast<int>(static_cast<qint64>(wordsCount) * (in_slice + 1) / shardsCount);
+    for (int i = static_cast<int>(static_cast<qint64>(wordsCount) * in_slice / shardsCount); i < end; ++i) {
+        const char* word = in_words.wordData(i);
+        const int wordSize = in_words.wordSize(i);
+        if (wordSize < m_minLetterCombinationLength || TextEncoding::CharactersCount(word, wordSize) < m_minLetterCombinationLength) {
+            continue;
+        }
+        const quint64 count = in_words.wordCount(i);
+        enumerator.enumerate(word, wordSize, m_minLetterCombinationLength, m_maxLetterCombinationLength);
+        for (const auto& letterCombination : enumerator.letterCombinations()) {
+            const int shard = static_cast<int>((letterCombination.hash >> 32) % static_cast<quint64>(shardsCount));
+            m_inboxes[in_slice * shardsCount + shard].push_back({ word + letterCombination.offset, letterCombination.size, letterCombination.hash, count });
+        }
+        letterCombinationsCount += enumerator.letterCombinations().size() * count;
+    }
+    m_slicesLetterCombinationsCounts[in_slice] = letterCombinationsCount;
+}
+
+void CShardedDictionary::countShard(int in_shard)
+{
+    const Tracing::CSpan span("ShardedDictionary::countShard");
+    const AllocationProfiler::CStageScope stage(AllocationProfiler::esDictionaryInsert);
+    SShard& shard = *m_shards[in_shard];
+    auto isBetter = [&shard](quint32 lhs, quint32 rhs){
+        return shard.isBetter(lhs, rhs);
+    };
+
+    shard.isTopChanged = false;
+    const int shardsCount = static_cast<int>(m_shards.size());
+    for (int slice = 0; slice < shardsCount; ++slice) {
+        for (const auto& update : m_inboxes[slice * shardsCount + in_shard]) {
+            bool isAdded = false;
+            const quint32 id = shard.dictionary.intern(update.data, update.size, update.hash, isAdded);
+            if (isAdded) {
+                shard.counts.push_back(0);
+            }
+            shard.counts[id] += update.count;
+            if (shard.top.update(id, isBetter)) {
+                shard.isTopChanged = true;
+            }
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef SHARDEDDICTIONARY_H
+#define SHARDEDDICTIONARY_H
+
+#include "CommonData.h"
+#include "WordsBatch.h"
+#include "StringInterner.h"
+#include "TopKHeap.h"
+#include "LetterCombinationsEnumerator.h"
+
+#include <QThreadPool>
+
+#include <memory>
+#include <vector>
+
+//! The CShardedDictionary class counts letter combinations in several threads. The dictionary is divided into shards by letter combinations'
+//! hashes, every shard is updated by one thread at a time, so no locks are needed. A batch of words is processed in two phases:
+//! at first words are divided into slices, which letter combinations are enumerated in parallel and routed to shards' inboxes,
+//! then shards count letter combinations of their inboxes in parallel. Every letter combination is counted in exactly one shard,
+//! so the merged top of shards' tops is identical to the single-threaded result.
+class CShardedDictionary
+{
+public:
+    explicit CShardedDictionary(int in_shardsCount = 1);
+    ~CShardedDictionary();
+
+    //! Sets the number of shards and threads, removes all letter combinations.
+    void setShardsCount(int in_shardsCount);
+    int shardsCount() const { return static_cast<int>(m_shards.size()); }
+
+    //! Sets the range of counted letter combinations' lengths in characters. It must be set before letter combinations are added.
+    void setLetterCombinationsLengthRange(int in_minLength, int in_maxLength);
+
+    //! Sets the number of the most common letter combinations kept by shards and removes all letter combinations.
+    void setTopLetterCombinationsCount(int in_count);
+
+    //! Counts letter combinations of the given words.
+    //! @param inout_totalLetterCombinationsCount [in, out] - the total count of letter combinations, which is increased by counted ones.
+    //! @return true if the top letter combinations may have been changed.
+    bool addWords(const CWordsBatch& in_words, quint64& inout_totalLetterCombinationsCount);
+
+    //! Returns the given number of the most common letter combinations in count descending order. Equal counts are ordered by letter combinations.
+    WordsVector top(int in_count) const;
+
+    //! Passes every letter combination with its count to the handler with the (const char* data, int size, quint64 count) signature.
+    template<typename TLetterCombinationHandler>
+    void forEach(TLetterCombinationHandler&& in_onLetterCombination) const
+    {
+        for (const auto& shard : m_shards) {
+            for (quint32 id = 0; id < shard->dictionary.size(); ++id) {
+                in_onLetterCombination(shard->dictionary.data(id), shard->dictionary.size(id), shard->counts[id]);
+            }
+        }
+    }
+
+    //! Returns the number of distinct letter combinations in all shards.
+    quint64 size() const;
+
+    //! Returns the approximate memory taken by dictionaries of all shards in bytes.
+    size_t memoryUsage() const;
+
+    //! Removes all letter combinations.
+    void clear();
+
+private:
+    //! The letter combination routed to a shard. It points to the batch's data.
+    struct SUpdate
+    {
+        const char* data;
+        int size;
+        quint64 hash;
+        quint64 count;
+    };
+
+    struct SShard
+    {
+        explicit SShard(int in_topCount) : top(in_topCount) {}
+
+        bool isBetter(quint32 in_lhs, quint32 in_rhs) const
+        {
+            return counts[in_lhs] != counts[in_rhs] ? counts[in_lhs] > counts[in_rhs] : dictionary.isLess(in_lhs, in_rhs);
+        }
+
+        CStringInterner dictionary;
+        std::vector<quint64> counts;
+        CTopKHeap top;
+        bool isTopChanged { false };
+    };
+
+    //! Enumerates letter combinations of the slice of words and routes them to its shards' inboxes.
+    void routeSlice(const CWordsBatch& in_words, int in_slice);
+
+    //! Counts letter combinations of the shard's inboxes in slices' order.
+    void countShard(int in_shard);
+
+    std::vector<std::unique_ptr<SShard>> m_shards;
+    std::vector<CLetterCombinationsEnumerator> m_enumerators;   //!< Enumerators of slices.
+    std::vector<std::vector<SUpdate>> m_inboxes;                //!< Inboxes indexed by slice * shards count + shard.
+    std::vector<quint64> m_slicesLetterCombinationsCounts;
+    int m_minLetterCombinationLength { CommonData::MinLetterCombinationLength };
+    int m_maxLetterCombinationLength { CommonData::MaxLetterCombinationLength };
+    int m_topLetterCombinationsCount { CommonData::TopLetterCombinationsCount };
+    QThreadPool m_threadPool;
+};
+
+#endif // SHARDEDDICTIONARY_H
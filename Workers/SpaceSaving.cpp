@@ -0,0 +1,327 @@
+#include "SpaceSaving.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+    //! Returns the number of the index slots for the given number of counters: a power of two, which keeps the index at most half full.
+    qint64 indexSizeForCapacity(qint64 in_capacity)
+    {
+        qint64 indexSize = 1;
+        while (indexSize < 2 * in_capacity) {
+            indexSize *= 2;
+        }
+        return indexSize;
+    }
+
+} // namespace
+
+CSpaceSaving::CSpaceSaving(qint64 in_memoryBudget)
+{
+    setMemoryBudget(in_memoryBudget);
+}
+
+int CSpaceSaving::capacityForMemoryBudget(qint64 in_memoryBudget, int in_minCapacity)
+{
+    // A counter takes its structure, its string's buffer, its heap entry and two index slots.
+    constexpr qint64 counterSize = sizeof(SCounter) + ExpectedKeySize + KeyOverhead + sizeof(quint32);
+    constexpr qint64 indexSlotsSize = 2 * sizeof(quint32);
+    const qint64 minCapacity = std::max(in_minCapacity, 1);
+    qint64 capacity = std::min<qint64>(in_memoryBudget / (counterSize + indexSlotsSize), EmptySlot / 4);
+
+    // The index is rounded up to a power of two, so the counters get the rest of the budget after the index and the top.
+    const qint64 restMemoryBudget = in_memoryBudget - indexSizeForCapacity(capacity) * sizeof(quint32) - minCapacity * sizeof(quint32);
+    capacity = std::min(capacity, restMemoryBudget / counterSize);
+    return static_cast<int>(std::max(capacity, minCapacity));
+}
+
+void CSpaceSaving::setMemoryBudget(qint64 in_memoryBudget)
+{
+    m_memoryBudget = in_memoryBudget;
+    m_capacity = capacityForMemoryBudget(m_memoryBudget, m_topCount);
+    clear();
+}
+
+void CSpaceSaving::setTopCount(int in_topCount)
+{
+    m_topCount = std::max(in_topCount, 0);
+    m_capacity = capacityForMemoryBudget(m_memoryBudget, m_topCount);
+    clear();
+}
+
+bool CSpaceSaving::add(const char* in_data, int in_size, quint64 in_hash, quint64 in_weight)
+{
+    if (m_index.empty()) {
+        allocate();
+    }
+
+    m_totalWeight += in_weight;
+    size_t slot = findSlot(in_data, in_size, in_hash);
+    if (m_index[slot] != EmptySlot) {
+        const quint32 id = m_index[slot];
+        m_counters[id].count += in_weight;
+        siftDown(m_counters[id].heapPosition);
+        return updateTop(id);
+    }
+
+    // New counters are added until the counters or the memory run out, the top always gets its counters.
+    // After strings have been replaced no counters are added, since the new string's count would have to include untracked occurrences.
+    const int size = this->size();
+    if (!m_isFull && size < m_capacity
+        && (size < m_topCount || memoryUsage() + static_cast<size_t>(in_size) + KeyOverhead <= static_cast<size_t>(m_memoryBudget))) {
+        const quint32 id = static_cast<quint32>(m_counters.size());
+        m_counters.push_back({ QByteArray(in_data, in_size), in_hash, in_weight, 0, size, false });
+        m_keysMemory += keyMemory(m_counters.back().key);
+        m_heap.push_back(id);
+        m_index[slot] = id;
+        siftUp(size);
+        return updateTop(id);
+    }
+
+    // Replace the string with the minimum count, the new string inherits its count as the error.
+    m_isFull = true;
+    const quint32 id = m_heap.front();
+    SCounter& counter = m_counters[id];
+    removeFromIndex(findSlot(counter.key.constData(), counter.key.size(), counter.hash));
+    m_keysMemory -= keyMemory(counter.key);
+
+    // The buffer of the replaced string is reused unless it's much longer than needed, so short strings don't keep long strings' memory.
+    if (counter.key.capacity() >= in_size && counter.key.capacity() <= 2 * in_size + ExpectedKeySize) {
+        counter.key.resize(in_size);
+        std::memcpy(counter.key.data(), in_data, static_cast<size_t>(in_size));
+    } else {
+        counter.key = QByteArray(in_data, in_size);
+    }
+    m_keysMemory += keyMemory(counter.key);
+    counter.hash = in_hash;
+    counter.error = counter.count;
+    counter.count += in_weight;
+    slot = findSlot(in_data, in_size, in_hash);
+    m_index[slot] = id;
+    siftDown(0);
+
+    // The string of a counter in the top has changed, so the top has changed.
+    const bool isTopChanged = updateTop(id);
+    dropCounters();
+    return isTopChanged;
+}
+
+WordsVector CSpaceSaving::top(QVector<quint64>& out_errorBounds) const
+{
+    std::vector<quint32> ids(m_topIds);
+    std::sort(std::begin(ids), std::end(ids), [this](quint32 lhs, quint32 rhs){
+        const SCounter& lhsCounter = m_counters[lhs];
+        const SCounter& rhsCounter = m_counters[rhs];
+        return lhsCounter.count != rhsCounter.count ? lhsCounter.count > rhsCounter.count : lhsCounter.key < rhsCounter.key;
+    });
+
+    WordsVector result;
+    out_errorBounds.clear();
+    for (const quint32 id : ids) {
+        const SCounter& counter = m_counters[id];
+        result.push_back(QPair(QString::fromUtf8(counter.key), counter.count));
+        out_errorBounds.push_back(counter.error);
+    }
+    return result;
+}
+
+quint64 CSpaceSaving::untrackedCountBound() const
+{
+    return m_isFull && !m_heap.empty() ? m_counters[m_heap.front()].count : 0;
+}
+
+void CSpaceSaving::clear()
+{
+    // Containers are replaced rather than cleared to free their memory until the next string is added.
+    std::vector<SCounter>().swap(m_counters);
+    std::vector<quint32>().swap(m_heap);
+    std::vector<quint32>().swap(m_index);
+    std::vector<quint32>().swap(m_topIds);
+    m_topMinPosition = -1;
+    m_keysMemory = 0;
+    m_totalWeight = 0;
+    m_isFull = false;
+}
+
+void CSpaceSaving::allocate()
+{
+    m_index.assign(static_cast<size_t>(indexSizeForCapacity(m_capacity)), EmptySlot);
+    m_counters.reserve(static_cast<size_t>(m_capacity));
+    m_heap.reserve(static_cast<size_t>(m_capacity));
+    m_topIds.reserve(static_cast<size_t>(m_topCount));
+}
+
+size_t CSpaceSaving::findSlot(const char* in_data, int in_size, quint64 in_hash) const
+{
+    const size_t mask = m_index.size() - 1;
+    for (size_t slot = in_hash & mask; ; slot = (slot + 1) & mask) {
+        const quint32 id = m_index[slot];
+        if (id == EmptySlot) {
+            return slot;
+        }
+        const SCounter& counter = m_counters[id];
+        if (counter.hash == in_hash && counter.key.size() == in_size && !std::memcmp(counter.key.constData(), in_data, static_cast<size_t>(in_size))) {
+            return slot;
+        }
+    }
+}
+
+void CSpaceSaving::removeFromIndex(size_t in_slot)
+{
+    // Move back the following counters of the probe sequence, which can't be found after the slot is emptied.
+    const size_t mask = m_index.size() - 1;
+    size_t emptySlot = in_slot;
+    for (size_t slot = (in_slot + 1) & mask; m_index[slot] != EmptySlot; slot = (slot + 1) & mask) {
+        const size_t homeSlot = m_counters[m_index[slot]].hash & mask;
+        if (((slot - homeSlot) & mask) >= ((slot - emptySlot) & mask)) {
+            m_index[emptySlot] = m_index[slot];
+            emptySlot = slot;
+        }
+    }
+    m_index[emptySlot] = EmptySlot;
+}
+
+void CSpaceSaving::dropCounters()
+{
+    // The dropped string's count doesn't exceed the new minimum count, so untrackedCountBound() stays an upper bound of its true count.
+    while (memoryUsage() > static_cast<size_t>(m_memoryBudget) && size() > m_topCount) {
+        const quint32 id = m_heap.front();
+        const bool isInTop = m_counters[id].isInTop;
+        removeFromIndex(findSlot(m_counters[id].key.constData(), m_counters[id].key.size(), m_counters[id].hash));
+        m_keysMemory -= keyMemory(m_counters[id].key);
+
+        const quint32 lastId = m_heap.back();
+        m_heap.pop_back();
+        if (!m_heap.empty()) {
+            place(0, lastId);
+            siftDown(0);
+        }
+
+        // Move the last counter to the dropped one's place, so the counters stay contiguous.
+        const quint32 movedId = static_cast<quint32>(m_counters.size()) - 1;
+        if (id != movedId) {
+            SCounter& movedCounter = m_counters[movedId];
+            const size_t slot = findSlot(movedCounter.key.constData(), movedCounter.key.size(), movedCounter.hash);
+            m_counters[id] = std::move(movedCounter);
+            m_index[slot] = id;
+            m_heap[m_counters[id].heapPosition] = id;
+            siftUp(m_counters[id].heapPosition);
+            if (m_counters[id].isInTop) {
+                *std::find(std::begin(m_topIds), std::end(m_topIds), movedId) = id;
+            }
+        }
+        m_counters.pop_back();
+
+        if (isInTop) {
+            rebuildTop();
+        }
+    }
+}
+
+bool CSpaceSaving::updateTop(quint32 in_counter)
+{
+    SCounter& counter = m_counters[in_counter];
+    if (counter.isInTop) {
+        if (m_topIds[m_topMinPosition] == in_counter) {
+            findTopMin();
+        }
+        return true;
+    }
+    if (static_cast<int>(m_topIds.size()) < m_topCount) {
+        counter.isInTop = true;
+        m_topIds.push_back(in_counter);
+        if (m_topMinPosition < 0 || counter.count < m_counters[m_topIds[m_topMinPosition]].count) {
+            m_topMinPosition = static_cast<int>(m_topIds.size()) - 1;
+        }
+        return true;
+    }
+    if (!m_topCount || counter.count <= m_counters[m_topIds[m_topMinPosition]].count) {
+        return false;
+    }
+
+    // The counter displaces the minimum of the top.
+    m_counters[m_topIds[m_topMinPosition]].isInTop = false;
+    m_topIds[m_topMinPosition] = in_counter;
+    counter.isInTop = true;
+    findTopMin();
+    return true;
+}
+
+void CSpaceSaving::rebuildTop()
+{
+    for (const quint32 id : m_topIds) {
+        m_counters[id].isInTop = false;
+    }
+    std::vector<quint32> ids(m_counters.size());
+    for (quint32 id = 0; id < ids.size(); ++id) {
+        ids[id] = id;
+    }
+    const size_t topCount = std::min(ids.size(), static_cast<size_t>(m_topCount));
+    std::nth_element(std::begin(ids), std::begin(ids) + topCount, std::end(ids), [this](quint32 lhs, quint32 rhs){
+        return m_counters[lhs].count > m_counters[rhs].count;
+    });
+    m_topIds.assign(std::begin(ids), std::begin(ids) + topCount);
+    for (const quint32 id : m_topIds) {
+        m_counters[id].isInTop = true;
+    }
+    findTopMin();
+}
+
+void CSpaceSaving::findTopMin()
+{
+    m_topMinPosition = -1;
+    for (int i = 0; i < static_cast<int>(m_topIds.size()); ++i) {
+        if (m_topMinPosition < 0 || m_counters[m_topIds[i]].count < m_counters[m_topIds[m_topMinPosition]].count) {
+            m_topMinPosition = i;
+        }
+    }
+}
+
+bool CSpaceSaving::isLess(quint32 in_lhs, quint32 in_rhs) const
+{
+    const quint64 lhsCount = m_counters[in_lhs].count;
+    const quint64 rhsCount = m_counters[in_rhs].count;
+    return lhsCount != rhsCount ? lhsCount < rhsCount : in_lhs < in_rhs;
+}
+
+void CSpaceSaving::siftUp(int in_position)
+{
+    const quint32 id = m_heap[in_position];
+    while (in_position > 0) {
+        const int parent = (in_position - 1) / 2;
+        if (!isLess(id, m_heap[parent])) {
+            break;
+        }
+        place(in_position, m_heap[parent]);
+        in_position = parent;
+    }
+    place(in_position, id);
+}
+
+void CSpaceSaving::siftDown(int in_position)
+{
+    const quint32 id = m_heap[in_position];
+    const int size = static_cast<int>(m_heap.size());
+    for (;;) {
+        int child = 2 * in_position + 1;
+        if (child >= size) {
+            break;
+        }
+        if (child + 1 < size && isLess(m_heap[child + 1], m_heap[child])) {
+            ++child;
+        }
+        if (!isLess(m_heap[child], id)) {
+            break;
+        }
+        place(in_position, m_heap[child]);
+        in_position = child;
+    }
+    place(in_position, id);
+}
+
+void CSpaceSaving::place(int in_position, quint32 in_counter)
+{
+    m_heap[in_position] = in_counter;
+    m_counters[in_counter].heapPosition = in_position;
+}
@@ -0,0 +1,120 @@
+#ifndef SPACESAVING_H
+#define SPACESAVING_H
+
+#include "CommonData.h"
+
+#include <QByteArray>
+#include <QVector>
+
+#include <vector>
+
+//! The CSpaceSaving class finds the most common strings approximately by the Space-Saving algorithm in fixed memory.
+//! It tracks a bounded number of counters. A string, which isn't tracked while all counters are in use, replaces the counter with the minimum count
+//! and inherits that count as its error. So for every tracked string its true count lies in [count - error, count], the error never exceeds
+//! N / m, where N is the total weight of added strings and m is the number of counters, and every string, which true count is greater than N / m,
+//! is tracked. Strings' buffers are accounted in the memory budget: if strings are longer than expected, counters with the minimum counts
+//! are dropped to stay within the budget, so m may be lower than capacity().
+class CSpaceSaving
+{
+public:
+    static constexpr qint64 DefaultMemoryBudget = 64 * 1024 * 1024;
+
+    //! The expected size of strings, which the number of counters is calculated with.
+    static constexpr int ExpectedKeySize = 16;
+
+    explicit CSpaceSaving(qint64 in_memoryBudget = DefaultMemoryBudget);
+
+    //! Sets the memory budget in bytes and removes all strings. Memory is allocated by the first added string.
+    void setMemoryBudget(qint64 in_memoryBudget);
+
+    //! Sets the number of the most common strings returned by top() and removes all strings. There are at least as many counters.
+    void setTopCount(int in_topCount);
+
+    //! Returns the maximum number of counters.
+    int capacity() const { return m_capacity; }
+
+    //! Returns the maximum number of counters for the given memory budget.
+    static int capacityForMemoryBudget(qint64 in_memoryBudget, int in_minCapacity = CommonData::TopLetterCombinationsCount);
+
+    //! Adds the weight to the count of the given string.
+    //! @param in_hash [in] - the hash of the string, equal strings must have equal hashes.
+    //! @return true if the top has changed: the string has entered the top or its count in the top has grown.
+    bool add(const char* in_data, int in_size, quint64 in_hash, quint64 in_weight);
+
+    //! Returns the strings with the greatest estimated counts in count descending order. Equal counts are ordered by strings.
+    //! The top is kept by add(), so only its strings are sorted.
+    //! @param out_errorBounds [out] - the maximum overestimation of the corresponding count.
+    WordsVector top(QVector<quint64>& out_errorBounds) const;
+
+    //! Returns the upper bound of the true count of any string, which isn't tracked.
+    quint64 untrackedCountBound() const;
+
+    //! Returns the number of tracked strings, which doesn't exceed the number of counters.
+    int size() const { return static_cast<int>(m_heap.size()); }
+
+    //! Returns the memory taken by counters, strings' buffers and the index in bytes. It doesn't exceed the budget.
+    size_t memoryUsage() const
+    {
+        return m_counters.capacity() * sizeof(SCounter) + m_keysMemory + m_heap.capacity() * sizeof(quint32) + m_index.capacity() * sizeof(quint32)
+               + m_topIds.capacity() * sizeof(quint32);
+    }
+
+    //! Returns the total weight of added strings.
+    quint64 totalWeight() const { return m_totalWeight; }
+
+    //! Removes all strings and frees the memory.
+    void clear();
+
+private:
+    static constexpr quint32 EmptySlot = 0xFFFFFFFF;
+
+    //! The memory taken by a string's buffer besides its capacity: the header of the buffer and the allocator's one.
+    static constexpr int KeyOverhead = 32;
+
+    struct SCounter
+    {
+        QByteArray key;
+        quint64 hash;
+        quint64 count;
+        quint64 error;          //!< The count of the replaced string, which the string has inherited.
+        int heapPosition;
+        bool isInTop;
+    };
+
+    static size_t keyMemory(const QByteArray& in_key) { return in_key.capacity() + KeyOverhead; }
+
+    void allocate();
+
+    size_t findSlot(const char* in_data, int in_size, quint64 in_hash) const;
+    void removeFromIndex(size_t in_slot);
+
+    //! Drops counters with the minimum counts while strings' buffers exceed the memory budget.
+    void dropCounters();
+
+    //! Updates the top after the count of the counter has grown or its string has been replaced.
+    //! @return true if the top has changed.
+    bool updateTop(quint32 in_counter);
+
+    //! Finds the top among all counters. It's needed only if a counter of the top has been dropped.
+    void rebuildTop();
+    void findTopMin();
+
+    bool isLess(quint32 in_lhs, quint32 in_rhs) const;
+    void siftUp(int in_position);
+    void siftDown(int in_position);
+    void place(int in_position, quint32 in_counter);
+
+    qint64 m_memoryBudget { DefaultMemoryBudget };
+    int m_topCount { CommonData::TopLetterCombinationsCount };
+    int m_capacity { 0 };
+    bool m_isFull { false };                //!< Strings have been replaced, so untracked strings may have been counted.
+    quint64 m_totalWeight { 0 };
+    size_t m_keysMemory { 0 };              //!< The memory of strings' buffers.
+    std::vector<SCounter> m_counters;
+    std::vector<quint32> m_heap;            //!< Counters in a min-heap by count. The root is the counter to replace.
+    std::vector<quint32> m_index;           //!< Open addressing index of counters by strings, EmptySlot marks an empty slot. Its size is a power of two.
+    std::vector<quint32> m_topIds;          //!< Counters with the greatest counts, unordered.
+    int m_topMinPosition { -1 };            //!< The position of the counter with the minimum count in the top.
+};
+
+#endif // SPACESAVING_H
@@ -0,0 +1,91 @@
+#include "StringInterner.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+    constexpr size_t InitialIndexSize = 4096;
+
+} // namespace
+
+quint64 CStringInterner::hash(const char* in_data, int in_size)
+{
+    quint64 result = HashOffsetBasis;
+    for (int i = 0; i < in_size; ++i) {
+        result = extendHash(result, static_cast<uchar>(in_data[i]));
+    }
+    return result;
+}
+
+CStringInterner::CStringInterner()
+    : m_offsets(1, 0)
+    , m_index(InitialIndexSize, InvalidId)
+{}
+
+quint32 CStringInterner::intern(const char* in_data, int in_size, quint64 in_hash, bool& out_isAdded)
+{
+    const quint32 slot = findSlot(in_data, in_size, in_hash);
+    if (m_index[slot] != InvalidId) {
+        out_isAdded = false;
+        return m_index[slot];
+    }
+
+    const quint32 id = size();
+    m_index[slot] = id;
+    m_arena.insert(std::end(m_arena), in_data, in_data + in_size);
+    m_offsets.push_back(m_arena.size());
+    m_hashes.push_back(in_hash);
+    out_isAdded = true;
+
+    // Keep the load factor below one half.
+    if (m_hashes.size() * 2 > m_index.size()) {
+        growIndex();
+    }
+    return id;
+}
+
+quint32 CStringInterner::find(const char* in_data, int in_size, quint64 in_hash) const
+{
+    return m_index[findSlot(in_data, in_size, in_hash)];
+}
+
+void CStringInterner::clear()
+{
+    m_arena.clear();
+    m_offsets.assign(1, 0);
+    m_hashes.clear();
+    std::fill(std::begin(m_index), std::end(m_index), InvalidId);
+}
+
+bool CStringInterner::isLess(quint32 in_lhsId, quint32 in_rhsId) const
+{
+    const int lhsSize = size(in_lhsId);
+    const int rhsSize = size(in_rhsId);
+    const int result = std::memcmp(data(in_lhsId), data(in_rhsId), static_cast<size_t>(std::min(lhsSize, rhsSize)));
+    return result ? result < 0 : lhsSize < rhsSize;
+}
+
+quint32 CStringInterner::findSlot(const char* in_data, int in_size, quint64 in_hash) const
+{
+    const size_t mask = m_index.size() - 1;
+    for (size_t slot = in_hash & mask; ; slot = (slot + 1) & mask) {
+        const quint32 id = m_index[slot];
+        if (id == InvalidId || (m_hashes[id] == in_hash && size(id) == in_size && !std::memcmp(data(id), in_data, static_cast<size_t>(in_size)))) {
+            return static_cast<quint32>(slot);
+        }
+    }
+}
+
+void CStringInterner::growIndex()
+{
+    m_index.assign(m_index.size() * 2, InvalidId);
+    const size_t mask = m_index.size() - 1;
+    for (quint32 id = 0; id < size(); ++id) {
+        size_t slot = m_hashes[id] & mask;
+        while (m_index[slot] != InvalidId) {
+            slot = (slot + 1) & mask;
+        }
+        m_index[slot] = id;
+    }
+}
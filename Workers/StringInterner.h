@@ -0,0 +1,60 @@
+#ifndef STRINGINTERNER_H
+#define STRINGINTERNER_H
+
+#include <QtGlobal>
+
+#include <vector>
+
+//! The CStringInterner class assigns dense 32-bit identifiers to distinct byte strings.
+//! Strings are stored one after another in a contiguous arena and found by an open addressing index, which compares full strings,
+//! so different strings with equal hashes never share an identifier. Data attached to strings (counts, etc.) should be kept
+//! by the owner in contiguous arrays indexed by identifiers.
+class CStringInterner
+{
+public:
+    static constexpr quint32 InvalidId = 0xFFFFFFFF;
+
+    // Parameters of the 64-bit FNV-1a hash. The hash may be calculated incrementally by the bytes of the string.
+    static constexpr quint64 HashOffsetBasis = 14695981039346656037ULL;
+    static constexpr quint64 HashPrime = 1099511628211ULL;
+
+    static quint64 extendHash(quint64 in_hash, uchar in_byte) { return (in_hash ^ in_byte) * HashPrime; }
+    static quint64 hash(const char* in_data, int in_size);
+
+    CStringInterner();
+
+    //! Returns the identifier of the given string, the string is added if it's missing.
+    //! @param in_hash [in] - the hash of the string calculated by hash().
+    //! @param out_isAdded [out] - true if the string has been added.
+    quint32 intern(const char* in_data, int in_size, quint64 in_hash, bool& out_isAdded);
+
+    //! Returns the identifier of the given string or InvalidId if it's missing.
+    quint32 find(const char* in_data, int in_size, quint64 in_hash) const;
+
+    //! Removes all strings and keeps the allocated memory.
+    void clear();
+
+    //! Returns the number of strings. Identifiers are numbers from zero to this value.
+    quint32 size() const { return static_cast<quint32>(m_hashes.size()); }
+
+    //! Returns the string's data, which is valid until the next string is added.
+    const char* data(quint32 in_id) const { return m_arena.data() + m_offsets[in_id]; }
+    int size(quint32 in_id) const { return static_cast<int>(m_offsets[in_id + 1] - m_offsets[in_id]); }
+
+    //! Returns the approximate memory taken by the stored strings in bytes. The memory kept after clearing isn't counted.
+    size_t memoryUsage() const { return m_arena.size() + m_hashes.size() * (2 * sizeof(quint64) + 2 * sizeof(quint32)); }
+
+    //! Compares strings with the given identifiers lexicographically by bytes.
+    bool isLess(quint32 in_lhsId, quint32 in_rhsId) const;
+
+private:
+    quint32 findSlot(const char* in_data, int in_size, quint64 in_hash) const;
+    void growIndex();
+
+    std::vector<char> m_arena;          //!< Strings one after another.
+    std::vector<quint64> m_offsets;     //!< Strings' offsets in the arena and the arena size at the end.
+    std::vector<quint64> m_hashes;      //!< Strings' hashes. They are used to skip comparing of different strings and to grow the index.
+    std::vector<quint32> m_index;       //!< Open addressing index of strings' identifiers, InvalidId marks an empty slot. Its size is a power of two.
+};
+
+#endif // STRINGINTERNER_H
@@ -0,0 +1,270 @@
+#include "SuffixAutomaton.h"
+#include "TextEncoding.h"
+
+#include <algorithm>
+
+namespace {
+
+    constexpr int InitialTransitionsBits = 12;
+    constexpr quint64 EmptyKey = ~quint64(0);
+
+    quint64 transitionKey(quint32 in_state, uint in_codePoint)
+    {
+        return (static_cast<quint64>(in_state) << 32) | in_codePoint;
+    }
+
+} // namespace
+
+CSuffixAutomaton::CSuffixAutomaton()
+{
+    clear();
+}
+
+quint32 CSuffixAutomaton::addWord(const uint* in_codePoints, int in_size)
+{
+    const quint32 begin = static_cast<quint32>(m_codePoints.size());
+    m_codePoints.insert(std::end(m_codePoints), in_codePoints, in_codePoints + in_size);
+    quint32 last = 0;
+    for (int i = 0; i < in_size; ++i) {
+        last = extend(last, in_codePoints[i], begin + i + 1);
+        m_prefixStates.push_back(last);
+    }
+    m_wordsEnds.push_back(static_cast<quint32>(m_codePoints.size()));
+    m_wordsCounts.push_back(0);
+    return static_cast<quint32>(m_wordsEnds.size() - 1);
+}
+
+WordsVector CSuffixAutomaton::topSubstrings(int in_minLength, int in_maxLength, int in_count)
+{
+    countOccurrences();
+
+    // Find states having substrings of lengths in the range and order them by count.
+    auto lowestLength = [this, in_minLength](quint32 state){
+        return std::max(m_lengths[m_links[state]] + 1, in_minLength);
+    };
+    auto highestLength = [this, in_maxLength](quint32 state){
+        return std::min(m_lengths[state], in_maxLength);
+    };
+    std::vector<quint32> states;
+    for (quint32 state = 1; state < m_lengths.size(); ++state) {
+        if (m_counts[state] && lowestLength(state) <= highestLength(state)) {
+            states.push_back(state);
+        }
+    }
+    std::sort(std::begin(states), std::end(states), [this](quint32 lhs, quint32 rhs){
+        return m_counts[lhs] > m_counts[rhs];
+    });
+
+    // Substrings counted less than the count of the last substring in the top can't get into it.
+    quint64 minCount = 0;
+    qint64 substringsCount = 0;
+    for (const auto state : states) {
+        substringsCount += highestLength(state) - lowestLength(state) + 1;
+        if (substringsCount >= in_count) {
+            minCount = m_counts[state];
+            break;
+        }
+    }
+
+    // Substrings with equal counts are ordered by their code points, it's the order of their UTF-8 bytes.
+    std::vector<SSubstring> substrings;
+    for (const auto state : states) {
+        if (m_counts[state] < minCount) {
+            break;
+        }
+        for (int length = lowestLength(state); length <= highestLength(state); ++length) {
+            substrings.push_back({ state, length });
+        }
+    }
+    const size_t topCount = std::min(substrings.size(), static_cast<size_t>(std::max(in_count, 0)));
+    std::partial_sort(std::begin(substrings), std::begin(substrings) + topCount, std::end(substrings), [this](const SSubstring& lhs, const SSubstring& rhs){
+        if (m_counts[lhs.state] != m_counts[rhs.state]) {
+            return m_counts[lhs.state] > m_counts[rhs.state];
+        }
+        const uint* lhsEnd = m_codePoints.data() + m_ends[lhs.state];
+        const uint* rhsEnd = m_codePoints.data() + m_ends[rhs.state];
+        return std::lexicographical_compare(lhsEnd - lhs.length, lhsEnd, rhsEnd - rhs.length, rhsEnd);
+    });
+
+    WordsVector result;
+    QByteArray substring;
+    for (size_t i = 0; i < topCount; ++i) {
+        substring.resize(0);
+        const uint* end = m_codePoints.data() + m_ends[substrings[i].state];
+        for (const uint* codePoint = end - substrings[i].length; codePoint != end; ++codePoint) {
+            TextEncoding::AppendUtf8(*codePoint, substring);
+        }
+        result.push_back(QPair(QString::fromUtf8(substring), m_counts[substrings[i].state]));
+    }
+    return result;
+}
+
+size_t CSuffixAutomaton::memoryUsage() const
+{
+    return m_codePoints.size() * sizeof(uint) + (m_prefixStates.size() + m_wordsEnds.size() + m_links.size() + m_ends.size() + m_firstEdges.size()) * sizeof(quint32)
+            + (m_wordsCounts.size() + m_counts.size()) * sizeof(quint64) + m_lengths.size() * sizeof(int) + m_edges.size() * sizeof(SEdge)
+            + m_transitionsKeys.size() * (sizeof(quint64) + sizeof(quint32));
+}
+
+void CSuffixAutomaton::clear()
+{
+    m_codePoints.clear();
+    m_prefixStates.clear();
+    m_wordsEnds.clear();
+    m_wordsCounts.clear();
+    m_lengths.clear();
+    m_links.clear();
+    m_ends.clear();
+    m_firstEdges.clear();
+    m_counts.clear();
+    m_edges.clear();
+    m_transitionsBits = InitialTransitionsBits;
+    m_transitionsKeys.assign(size_t(1) << m_transitionsBits, EmptyKey);
+    m_transitionsTargets.assign(m_transitionsKeys.size(), InvalidState);
+    m_transitionsCount = 0;
+
+    // The root state represents the empty string.
+    addState(0, InvalidState, 0);
+}
+
+quint32 CSuffixAutomaton::extend(quint32 in_last, uint in_codePoint, quint32 in_end)
+{
+    // The string already occurs in previous words, its state is split if it represents longer strings too.
+    quint32 next = transition(in_last, in_codePoint);
+    if (next != InvalidState) {
+        if (m_lengths[in_last] + 1 == m_lengths[next]) {
+            return next;
+        }
+        const quint32 clone = cloneState(next, m_lengths[in_last] + 1);
+        for (quint32 state = in_last; state != InvalidState && transition(state, in_codePoint) == next; state = m_links[state]) {
+            setTransition(state, in_codePoint, clone);
+        }
+        m_links[next] = clone;
+        return clone;
+    }
+
+    const quint32 current = addState(m_lengths[in_last] + 1, InvalidState, in_end);
+    quint32 state = in_last;
+    for (; state != InvalidState && transition(state, in_codePoint) == InvalidState; state = m_links[state]) {
+        setTransition(state, in_codePoint, current);
+    }
+    if (state == InvalidState) {
+        m_links[current] = 0;
+        return current;
+    }
+
+    next = transition(state, in_codePoint);
+    if (m_lengths[state] + 1 == m_lengths[next]) {
+        m_links[current] = next;
+        return current;
+    }
+    const quint32 clone = cloneState(next, m_lengths[state] + 1);
+    for (; state != InvalidState && transition(state, in_codePoint) == next; state = m_links[state]) {
+        setTransition(state, in_codePoint, clone);
+    }
+    m_links[next] = clone;
+    m_links[current] = clone;
+    return current;
+}
+
+quint32 CSuffixAutomaton::addState(int in_length, quint32 in_link, quint32 in_end)
+{
+    m_lengths.push_back(in_length);
+    m_links.push_back(in_link);
+    m_ends.push_back(in_end);
+    m_firstEdges.push_back(InvalidState);
+    return static_cast<quint32>(m_lengths.size() - 1);
+}
+
+quint32 CSuffixAutomaton::cloneState(quint32 in_state, int in_length)
+{
+    const quint32 clone = addState(in_length, m_links[in_state], m_ends[in_state]);
+    for (quint32 edge = m_firstEdges[in_state]; edge != InvalidState; edge = m_edges[edge].next) {
+        const uint codePoint = m_edges[edge].codePoint;
+        setTransition(clone, codePoint, transition(in_state, codePoint));
+    }
+    return clone;
+}
+
+quint32 CSuffixAutomaton::transition(quint32 in_state, uint in_codePoint) const
+{
+    return m_transitionsTargets[findTransitionSlot(transitionKey(in_state, in_codePoint))];
+}
+
+void CSuffixAutomaton::setTransition(quint32 in_state, uint in_codePoint, quint32 in_target)
+{
+    const quint64 key = transitionKey(in_state, in_codePoint);
+    const size_t slot = findTransitionSlot(key);
+    m_transitionsTargets[slot] = in_target;
+    if (m_transitionsKeys[slot] == key) {
+        return;
+    }
+
+    m_transitionsKeys[slot] = key;
+    m_edges.push_back({ in_codePoint, m_firstEdges[in_state] });
+    m_firstEdges[in_state] = static_cast<quint32>(m_edges.size() - 1);
+
+    // Keep the load factor below one half.
+    if (++m_transitionsCount * 2 > m_transitionsKeys.size()) {
+        growTransitions();
+    }
+}
+
+size_t CSuffixAutomaton::findTransitionSlot(quint64 in_key) const
+{
+    // Fibonacci hashing spreads consecutive states and code points over the table.
+    const size_t mask = m_transitionsKeys.size() - 1;
+    for (size_t slot = (in_key * 0x9E3779B97F4A7C15ULL) >> (64 - m_transitionsBits); ; slot = (slot + 1) & mask) {
+        if (m_transitionsKeys[slot] == in_key || m_transitionsKeys[slot] == EmptyKey) {
+            return slot;
+        }
+    }
+}
+
+void CSuffixAutomaton::growTransitions()
+{
+    std::vector<quint64> keys(size_t(1) << (m_transitionsBits + 1), EmptyKey);
+    std::vector<quint32> targets(keys.size(), InvalidState);
+    keys.swap(m_transitionsKeys);
+    targets.swap(m_transitionsTargets);
+    ++m_transitionsBits;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (keys[i] != EmptyKey) {
+            const size_t slot = findTransitionSlot(keys[i]);
+            m_transitionsKeys[slot] = keys[i];
+            m_transitionsTargets[slot] = targets[i];
+        }
+    }
+}
+
+void CSuffixAutomaton::countOccurrences()
+{
+    // Every prefix of a word occurs once per word occurrence.
+    m_counts.assign(m_lengths.size(), 0);
+    quint32 begin = 0;
+    for (size_t word = 0; word < m_wordsEnds.size(); ++word) {
+        for (quint32 i = begin; i < m_wordsEnds[word]; ++i) {
+            m_counts[m_prefixStates[i]] += m_wordsCounts[word];
+        }
+        begin = m_wordsEnds[word];
+    }
+
+    // Substrings occur wherever their extensions occur: add counts along suffix links from the longest states.
+    const int maxLength = *std::max_element(std::begin(m_lengths), std::end(m_lengths));
+    std::vector<quint32> lengthsOffsets(static_cast<size_t>(maxLength) + 2, 0);
+    for (const int length : m_lengths) {
+        ++lengthsOffsets[length + 1];
+    }
+    for (size_t i = 1; i < lengthsOffsets.size(); ++i) {
+        lengthsOffsets[i] += lengthsOffsets[i - 1];
+    }
+    std::vector<quint32> orderedStates(m_lengths.size());
+    for (quint32 state = 0; state < m_lengths.size(); ++state) {
+        orderedStates[lengthsOffsets[m_lengths[state]]++] = state;
+    }
+    for (auto it = orderedStates.rbegin(); it != orderedStates.rend(); ++it) {
+        if (m_links[*it] != InvalidState) {
+            m_counts[m_links[*it]] += m_counts[*it];
+        }
+    }
+}
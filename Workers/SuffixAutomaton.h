@@ -0,0 +1,87 @@
+#ifndef SUFFIXAUTOMATON_H
+#define SUFFIXAUTOMATON_H
+
+#include "CommonData.h"
+
+#include <vector>
+
+//! The CSuffixAutomaton class is the generalized suffix automaton of distinct words, which counts occurrences of all words' substrings
+//! weighted by words' counts. Every state of the automaton represents substrings of lengths (length of the suffix link's state, state length],
+//! which share the same set of occurrences, so counting takes time linear in the total length of distinct words instead of quadratic one.
+//! Words are sequences of code points, so substrings' lengths are measured in characters and their order is the order of UTF-8 bytes.
+class CSuffixAutomaton
+{
+public:
+    CSuffixAutomaton();
+
+    //! Adds the distinct word.
+    //! @return the word identifier. Identifiers are consecutive numbers starting from zero.
+    quint32 addWord(const uint* in_codePoints, int in_size);
+
+    //! Increases the count of the word with the given identifier.
+    void addWordCount(quint32 in_wordId, quint64 in_count) { m_wordsCounts[in_wordId] += in_count; }
+
+    //! Counts occurrences of substrings and returns the most common substrings, which lengths are in the given range, in count descending order.
+    //! Equal counts are ordered by substrings.
+    WordsVector topSubstrings(int in_minLength, int in_maxLength, int in_count);
+
+    //! Returns the number of states. Every state represents substrings, which share the same set of occurrences.
+    quint32 statesCount() const { return static_cast<quint32>(m_lengths.size()); }
+
+    //! Returns the approximate memory taken by words and states in bytes.
+    size_t memoryUsage() const;
+
+    //! Removes all words.
+    void clear();
+
+private:
+    static constexpr quint32 InvalidState = 0xFFFFFFFF;
+
+    //! The outgoing transition of a state. Transitions of a state form a linked list, which is used to copy them to a cloned state.
+    struct SEdge
+    {
+        uint codePoint;
+        quint32 next;
+    };
+
+    //! The substring given by the state and the length.
+    struct SSubstring
+    {
+        quint32 state;
+        int length;
+    };
+
+    //! Appends the code point ending at the given position to the string of the state.
+    //! @return the state of the extended string.
+    quint32 extend(quint32 in_last, uint in_codePoint, quint32 in_end);
+
+    quint32 addState(int in_length, quint32 in_link, quint32 in_end);
+    quint32 cloneState(quint32 in_state, int in_length);
+
+    quint32 transition(quint32 in_state, uint in_codePoint) const;
+    void setTransition(quint32 in_state, uint in_codePoint, quint32 in_target);
+    size_t findTransitionSlot(quint64 in_key) const;
+    void growTransitions();
+
+    //! Calculates occurrences' counts of states' substrings.
+    void countOccurrences();
+
+    std::vector<uint> m_codePoints;             //!< Words one after another.
+    std::vector<quint32> m_prefixStates;        //!< States of words' prefixes ending at the corresponding code points.
+    std::vector<quint32> m_wordsEnds;           //!< Words' end offsets in m_codePoints indexed by words' identifiers.
+    std::vector<quint64> m_wordsCounts;
+
+    std::vector<int> m_lengths;                 //!< The length of the longest substring of the state.
+    std::vector<quint32> m_links;               //!< Suffix links.
+    std::vector<quint32> m_ends;                //!< The end offset of an occurrence of the state's substrings in m_codePoints.
+    std::vector<quint32> m_firstEdges;          //!< The first transition of the state in m_edges.
+    std::vector<quint64> m_counts;              //!< Occurrences' counts of states' substrings.
+    std::vector<SEdge> m_edges;
+
+    std::vector<quint64> m_transitionsKeys;     //!< Open addressing table of transitions, the key is the state in the high half and the code point.
+    std::vector<quint32> m_transitionsTargets;
+    int m_transitionsBits { 0 };                //!< Logarithm of the transitions table size.
+    size_t m_transitionsCount { 0 };
+};
+
+#endif // SUFFIXAUTOMATON_H
@@ -1,121 +1,338 @@
 #include "TextAnalyzer.h"
+#include "TextEncoding.h"
+#include "Tracing.h"
+#include "AllocationProfiler.h"
 
 #include <QHash>
+#include <QtConcurrent>
 
 #include <algorithm>
+#include <limits>
 
-CTextAnalyzerWorker::CTextAnalyzerWorker() {};
-CTextAnalyzerWorker::~CTextAnalyzerWorker() {};
+namespace {
 
-void CTextAnalyzerWorker::process(const WordsMap& in_words)
+    //! Returns true if letter combinations of the word may be packed: all its characters are non-zero ASCII bytes.
+    bool isPackable(const char* in_word, int in_size)
+    {
+        for (int i = 0; i < in_size; ++i) {
+            const uchar byte = static_cast<uchar>(in_word[i]);
+            if (!byte || byte >= 0x80) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace
+
+CTextAnalyzerWorker::CTextAnalyzerWorker()
+    : m_topLetterCombinationsHeap(CommonData::TopLetterCombinationsCount)
+{}
+CTextAnalyzerWorker::~CTextAnalyzerWorker()
+{
+    waitForCheckpoint();
+}
+
+void CTextAnalyzerWorker::setWordsBatchQueue(const QSharedPointer<CWordsBatchQueue>& in_wordsBatchQueue)
+{
+    m_wordsBatchQueue = in_wordsBatchQueue;
+}
+
+void CTextAnalyzerWorker::setPipelineMetrics(const QSharedPointer<CPipelineMetrics>& in_pipelineMetrics)
+{
+    m_pipelineMetrics = in_pipelineMetrics;
+}
+
+void CTextAnalyzerWorker::setLetterCombinationsLengthRange(int in_minLength, int in_maxLength)
+{
+    m_minLetterCombinationLength = std::max(in_minLength, 1);
+    m_maxLetterCombinationLength = in_maxLength > 0 ? std::max(in_maxLength, m_minLetterCombinationLength) : std::numeric_limits<int>::max();
+    m_shardedDictionary.setLetterCombinationsLengthRange(m_minLetterCombinationLength, m_maxLetterCombinationLength);
+
+    // Cached letter combinations of words have been found for the previous range.
+    m_wordsCombinationsCache.clear();
+}
+
+void CTextAnalyzerWorker::setTopLetterCombinationsCount(int in_count)
+{
+    m_topLetterCombinationsCount = std::max(in_count, 0);
+    m_topLetterCombinationsHeap.setCapacity(m_topLetterCombinationsCount);
+    m_shardedDictionary.setTopLetterCombinationsCount(m_topLetterCombinationsCount);
+    m_spaceSaving.setTopCount(m_topLetterCombinationsCount);
+}
+
+void CTextAnalyzerWorker::setEngine(CommonData::ELetterCombinationsEngine in_engine)
+{
+    m_engine = in_engine;
+}
+
+void CTextAnalyzerWorker::setSpillMemoryBudget(qint64 in_memoryBudget)
 {
-    processImpl(in_words);
+    m_spillMemoryBudget = in_memoryBudget;
+}
+
+void CTextAnalyzerWorker::setSpillDirectory(const QString& in_directory)
+{
+    m_dictionarySpill.setDirectory(in_directory);
+}
+
+void CTextAnalyzerWorker::setShardsCount(int in_shardsCount)
+{
+    m_shardedDictionary.setShardsCount(in_shardsCount);
+}
+
+void CTextAnalyzerWorker::setWordsCombinationsCacheCapacity(qint64 in_capacity)
+{
+    m_wordsCombinationsCache.setCapacity(in_capacity);
+}
+
+void CTextAnalyzerWorker::setApproximationMemoryBudget(qint64 in_memoryBudget)
+{
+    m_spaceSaving.setMemoryBudget(in_memoryBudget);
+}
+
+void CTextAnalyzerWorker::setCheckpointFileName(const QString& in_fileName)
+{
+    m_checkpoint.setFileName(in_fileName);
+}
+
+void CTextAnalyzerWorker::setCheckpointInterval(int in_interval)
+{
+    m_checkpointInterval = in_interval;
+}
+
+void CTextAnalyzerWorker::setResultIndexFileName(const QString& in_fileName)
+{
+    m_resultIndexFileName = in_fileName;
+}
+
+quint64 CTextAnalyzerWorker::dictionarySize() const
+{
+    if (m_engine == CommonData::elceSuffixAutomaton) {
+        return m_suffixAutomaton.statesCount();
+    }
+    if (m_engine == CommonData::elceSpaceSaving) {
+        return static_cast<quint64>(m_spaceSaving.size());
+    }
+    return isShardedDictionaryUsed() ? m_shardedDictionary.size() : m_dictionary.size();
+}
+
+size_t CTextAnalyzerWorker::memoryUsage() const
+{
+    if (m_engine == CommonData::elceSuffixAutomaton) {
+        return m_suffixAutomaton.memoryUsage() + m_analyzedWords.memoryUsage();
+    }
+    if (m_engine == CommonData::elceSpaceSaving) {
+        return m_spaceSaving.memoryUsage();
+    }
+    return isShardedDictionaryUsed() ? m_shardedDictionary.memoryUsage() : dictionaryMemoryUsage();
+}
+
+bool CTextAnalyzerWorker::resumeFromCheckpoint(const QString& in_sourceFileName, qint64& out_resumeOffset)
+{
+    finishProcessing();
+    m_checkpoint.setSourceFileName(in_sourceFileName);
+    m_checkpointTimer.start();
+    out_resumeOffset = 0;
+    if (!isCheckpointSupported() || !m_checkpoint.read(out_resumeOffset, [this](QDataStream& inout_stream){ return readCheckpointState(inout_stream); })) {
+        finishProcessing();
+        m_checkpointTimer.start();
+        out_resumeOffset = 0;
+        return false;
+    }
+    m_resumeOffset = out_resumeOffset;
+    m_checkpointResumeOffset = out_resumeOffset;
+    return true;
+}
+
+void CTextAnalyzerWorker::resume(const QString& in_sourceFileName)
+{
+    // The file reader is started by resumed(), so the queue is reset while neither side uses it.
+    if (m_wordsBatchQueue) {
+        m_wordsBatchQueue->reset();
+    }
+    qint64 resumeOffset = 0;
+    resumeFromCheckpoint(in_sourceFileName, resumeOffset);
+    emit resumed(in_sourceFileName, resumeOffset);
+}
+
+void CTextAnalyzerWorker::processQueue()
+{
+    Q_ASSERT(m_wordsBatchQueue);
+
+    // The span of waiting shows stalls of the text analyzer, while the file reader lags behind.
+    auto popBatch = [this](){
+        const Tracing::CSpan span("TextAnalyzer::waitForBatch");
+        return m_wordsBatchQueue->pop();
+    };
+    while (auto batch = popBatch()) {
+        processImpl(*batch);
+        if (batch->resumeOffset() >= 0) {
+            m_resumeOffset = batch->resumeOffset();
+        }
+        m_wordsBatchQueue->release(std::move(batch));
+        if (m_pipelineMetrics) {
+            m_pipelineMetrics->setAnalyzerState(m_wordsProcessed, dictionarySize(), m_wordsCombinationsCache.hitsCount(),
+                                                m_wordsCombinationsCache.missesCount(), memoryUsage());
+        }
+        if (m_checkpointTimer.isValid() && m_checkpointTimer.hasExpired(m_checkpointInterval)) {
+            writeCheckpoint();
+        }
+    }
+
+    // Keep the state of the interrupted reading. The completely read file doesn't need a checkpoint.
+    if (m_resumeOffset < m_checkpoint.sourceSize()) {
+        writeCheckpoint(true);
+    }
 }
 
 void CTextAnalyzerWorker::finishTextAnalyzing()
 {
-    processImpl({ { "", 0 } }, true);
+    // The index is written before the result is emitted, so it's ready when text analyzing is reported finished.
+    // The index of the dictionary written to disk would hold all letter combinations in memory, which breaks the spilling memory budget.
+    if (!m_resultIndexFileName.isEmpty() && m_engine == CommonData::elceEnumerator && !m_dictionarySpill.runsCount()) {
+        writeResultIndex();
+    }
+    processImpl(CWordsBatch(), true);
+    waitForCheckpoint();
+    m_checkpoint.remove();
 }
 
 void CTextAnalyzerWorker::finishProcessing()
 {
+    waitForCheckpoint();
     m_dictionary.clear();
+    m_letterCombinationsCounts.clear();
+    m_packedLetterCombinations.clear();
+    m_analyzedWords.clear();
+    m_wordsCombinationsCache.reset();
     m_topLetterCombinations.clear();
     m_topLetterCombinations.shrink_to_fit();
-    m_wordsLetterCombinations.clear();
-    m_topLetterCombinationsMinCount = 0;
+    m_topLetterCombinationsHeap.clear();
+    m_suffixAutomaton.clear();
+    m_spaceSaving.clear();
+    m_dictionarySpill.clear();
+    m_isSpillFailed = false;
+    m_shardedDictionary.clear();
+    m_checkpointTimer.invalidate();
+    m_resumeOffset = -1;
+    m_checkpointResumeOffset = -1;
     m_totalLetterCombinationsCount = 0;
     m_wordsProcessed = 0;
 }
 
-void CTextAnalyzerWorker::processImpl(const WordsMap& in_words, bool in_force)
+void CTextAnalyzerWorker::processImpl(const CWordsBatch& in_words, bool in_force)
 {
+    const Tracing::CSpan span("TextAnalyzer::processImpl");
+    const AllocationProfiler::CStageScope stage(AllocationProfiler::esDictionaryInsert);
+
+    // Equal counts are ordered by letter combinations to make the top independent of the words' order.
+    auto isBetter = [this](quint32 lhs, quint32 rhs){
+        const quint64 lhsCount = m_letterCombinationsCounts[lhs];
+        const quint64 rhsCount = m_letterCombinationsCounts[rhs];
+        return lhsCount != rhsCount ? lhsCount > rhsCount : m_dictionary.isLess(lhs, rhs);
+    };
+
     bool isNeedToUpdateTopLetterCombinations = false;
-    for (const auto& [word, count] : CommonData::asKeyValueRange(in_words)) {
-        if (word.isEmpty()) {
+    const bool isSharded = isShardedDictionaryUsed();
+    for (int i = 0; i < in_words.size(); ++i) {
+        const char* word = in_words.wordData(i);
+        const int wordSize = in_words.wordSize(i);
+        const quint64 count = in_words.wordCount(i);
+
+        m_wordsProcessed += count;
+        if (isSharded || wordSize < m_minLetterCombinationLength || TextEncoding::CharactersCount(word, wordSize) < m_minLetterCombinationLength) {
             continue;
         }
 
-        m_wordsProcessed += count;
-        if (word.size() < CommonData::MinLetterCombinationLength) {
+        if (m_engine == CommonData::elceSuffixAutomaton) {
+            addWordToSuffixAutomaton(word, wordSize, count);
+            continue;
+        }
+        if (m_engine == CommonData::elceSpaceSaving) {
+            if (addWordToSpaceSaving(word, wordSize, count)) {
+                isNeedToUpdateTopLetterCombinations = true;
+            }
             continue;
         }
 
-        // Check if the word with the calculated hash had already been analyzed and its letter combinations contained in storage.
-        auto hash = qHash(word);
-        auto wordsLetterCombinationIt = m_wordsLetterCombinations.find(hash);
-        if (wordsLetterCombinationIt != m_wordsLetterCombinations.end()) {
-            auto wordLetterCombinations = m_wordsLetterCombinations[hash];
-            auto& wordCount = count;
-            std::for_each(std::begin(wordLetterCombinations), std::end(wordLetterCombinations), [&](const auto& p){
-                const quint64 updatedWordLetterCombinationsCount = p.second * wordCount;
-                auto it = m_dictionary.find(p.first);
-                if (it != std::end(m_dictionary)) {
-                    it->second.second += updatedWordLetterCombinationsCount;
-                    if (!isNeedToUpdateTopLetterCombinations && it->second.second > m_topLetterCombinationsMinCount) {
-                        isNeedToUpdateTopLetterCombinations = true;
-                    }
-                }
-                m_totalLetterCombinationsCount += updatedWordLetterCombinationsCount;
-            });
-        } else {
-            auto wordLetterCombinations = findWordSubstrings(word);
-            LetterCombinationsMap letterHashCombinations;
-            for (const auto& [letterCombinationHash, letterCombinationData] : wordLetterCombinations) {
-                letterHashCombinations[letterCombinationHash] = letterCombinationData.second;
+        // Letter combinations of a repeated word are taken from the cache, otherwise they are found and added to the cache.
+        const quint64 wordHash = CStringInterner::hash(word, wordSize);
+        const CWordsCombinationsCache::SLetterCombination* wordLetterCombinationsBegin = nullptr;
+        const CWordsCombinationsCache::SLetterCombination* wordLetterCombinationsEnd = nullptr;
+        if (!m_wordsCombinationsCache.find(word, wordSize, wordHash, wordLetterCombinationsBegin, wordLetterCombinationsEnd)) {
+            addWordLetterCombinations(word, wordSize);
+            m_wordsCombinationsCache.insert(word, wordSize, wordHash, m_wordLetterCombinations);
+            wordLetterCombinationsBegin = m_wordLetterCombinations.data();
+            wordLetterCombinationsEnd = wordLetterCombinationsBegin + m_wordLetterCombinations.size();
+        }
+
+        for (auto it = wordLetterCombinationsBegin; it != wordLetterCombinationsEnd; ++it) {
+            const auto& wordLetterCombination = *it;
+            const quint64 updatedWordLetterCombinationsCount = static_cast<quint64>(wordLetterCombination.count) * count;
+            m_letterCombinationsCounts[wordLetterCombination.id] += updatedWordLetterCombinationsCount;
+            if (m_topLetterCombinationsHeap.update(wordLetterCombination.id, isBetter)) {
+                isNeedToUpdateTopLetterCombinations = true;
             }
-            m_wordsLetterCombinations[hash] = letterHashCombinations;
-            auto& wordCount = count;
-            std::for_each(std::begin(wordLetterCombinations), std::end(wordLetterCombinations), [&](const auto& p){
-                const quint64 updatedWordLetterCombinationsCount = p.second.second * wordCount;
-                auto it = m_dictionary.find(p.first);
-                if (it != std::end(m_dictionary)) {
-                    it->second.second += updatedWordLetterCombinationsCount;
-                    if (!isNeedToUpdateTopLetterCombinations && it->second.second > m_topLetterCombinationsMinCount) {
-                        isNeedToUpdateTopLetterCombinations = true;
-                    }
-                } else {
-                    m_dictionary[p.first] = { p.second.first, updatedWordLetterCombinationsCount };
-                    if (!isNeedToUpdateTopLetterCombinations && updatedWordLetterCombinationsCount > m_topLetterCombinationsMinCount) {
-                        isNeedToUpdateTopLetterCombinations = true;
-                    }
-                }
-                m_totalLetterCombinationsCount += updatedWordLetterCombinationsCount;
-            });
+            m_totalLetterCombinationsCount += updatedWordLetterCombinationsCount;
         }
     }
 
-    if (!in_force && !isNeedToUpdateTopLetterCombinations)
+    if (isSharded && m_shardedDictionary.addWords(in_words, m_totalLetterCombinationsCount)) {
+        isNeedToUpdateTopLetterCombinations = true;
+    }
+
+    // Counts of the dictionary are written to disk, when it reaches the memory budget.
+    if (m_engine == CommonData::elceEnumerator && !isSharded && m_spillMemoryBudget > 0 && !m_isSpillFailed
+            && dictionaryMemoryUsage() >= static_cast<size_t>(m_spillMemoryBudget)) {
+        spillDictionary();
+    }
+
+    // The suffix automaton and spilled counts give the top when text analyzing finishes.
+    if ((m_engine == CommonData::elceSuffixAutomaton || m_dictionarySpill.runsCount()) && !in_force) {
+        emit wordsProcessedCountUpdated(m_wordsProcessed);
         return;
+    }
 
-    // Copy the dictionary map to a vector and sort it in words' letter combinations count descending order.
-    DictionaryVector vDictionary(m_dictionary.begin(), m_dictionary.end());
-    std::stable_sort(std::begin(vDictionary), std::end(vDictionary), [](const auto& lhs, const auto& rhs){
-        return lhs.second.second != rhs.second.second ? lhs.second.second > rhs.second.second : lhs.first < rhs.first;
-    });
+    if (in_force && m_engine == CommonData::elceEnumerator && !isSharded) {
+        emit wordsCombinationsCacheStatisticsUpdated(m_wordsCombinationsCache.hitsCount(), m_wordsCombinationsCache.missesCount());
+    }
+
+    if (!in_force && !isNeedToUpdateTopLetterCombinations)
+        return;
 
-    // Obtain the most common words' letter combinations from the dictionary.
+    // Obtain the most common words' letter combinations in count descending order.
     WordsVector vTopLetterCombinations;
-    DictionaryVector vTopLetterCombinationsDictionary;
-    std::copy_n(std::begin(vDictionary), std::min(static_cast<size_t>(CommonData::TopLetterCombinationsCount), vDictionary.size()), std::back_inserter(vTopLetterCombinationsDictionary));
-    std::transform(std::begin(vTopLetterCombinationsDictionary), std::end(vTopLetterCombinationsDictionary), std::back_inserter(vTopLetterCombinations), [](const auto& el) {
-        return QPair(el.second.first, el.second.second);
-    });
+    QVector<quint64> vTopLetterCombinationsErrorBounds;
+    {
+        const Tracing::CSpan rebuildTopSpan("TextAnalyzer::rebuildTop");
+        const AllocationProfiler::CStageScope rebuildTopStage(AllocationProfiler::esTopK);
+        if (m_engine == CommonData::elceSuffixAutomaton) {
+            vTopLetterCombinations = m_suffixAutomaton.topSubstrings(m_minLetterCombinationLength, m_maxLetterCombinationLength, m_topLetterCombinationsCount);
+        } else if (isSharded) {
+            vTopLetterCombinations = m_shardedDictionary.top(m_topLetterCombinationsCount);
+        } else if (m_dictionarySpill.runsCount()) {
+            vTopLetterCombinations = m_dictionarySpill.mergeTop(m_dictionary, m_letterCombinationsCounts, m_topLetterCombinationsCount);
+        } else if (m_engine == CommonData::elceSpaceSaving) {
+            vTopLetterCombinations = m_spaceSaving.top(vTopLetterCombinationsErrorBounds);
+        } else {
+            const auto topLetterCombinationsIds = m_topLetterCombinationsHeap.sortedIds(isBetter);
+            std::transform(std::begin(topLetterCombinationsIds), std::end(topLetterCombinationsIds), std::back_inserter(vTopLetterCombinations), [this](quint32 id) {
+                return QPair(QString::fromUtf8(m_dictionary.data(id), m_dictionary.size(id)), m_letterCombinationsCounts[id]);
+            });
+        }
+    }
 
     // Check if the most common words' letter combinations have been changed.
     if (vTopLetterCombinations != m_topLetterCombinations) {
         m_topLetterCombinations = vTopLetterCombinations;
-
-        // Calculate and store minimum letter combinations count in the most common words' letter combinations.
-        QVector<quint64> vTopLetterCombinationsCount;
-        std::transform(std::begin(vTopLetterCombinations), std::end(vTopLetterCombinations), std::back_inserter(vTopLetterCombinationsCount), [](const auto& el) {
-            return el.second;
-        });
-        auto minWordsCountIt = std::min_element(std::begin(vTopLetterCombinationsCount), std::end(vTopLetterCombinationsCount));
-        if (minWordsCountIt != std::end(vTopLetterCombinationsCount)) {
-            m_topLetterCombinationsMinCount = *minWordsCountIt;
+        if (m_engine == CommonData::elceSpaceSaving) {
+            WordsVector vErrorBounds;
+            for (int i = 0; i < vTopLetterCombinations.size(); ++i) {
+                vErrorBounds.push_back(QPair(vTopLetterCombinations[i].first, vTopLetterCombinationsErrorBounds[i]));
+            }
+            emit topLetterCombinationsErrorBoundsUpdated(vErrorBounds);
         }
-
         emit totalLetterCombinationsCountUpdated(m_totalLetterCombinationsCount);
         emit wordsProcessedCountUpdated(m_wordsProcessed);
         if (!in_force) {
@@ -124,35 +341,283 @@ void CTextAnalyzerWorker::processImpl(const WordsMap& in_words, bool in_force)
             emit textAnalyzingFinished(vTopLetterCombinations);
         }
     } else {
+        // The final result carries the top even if it has been already sent by the last update.
         if (in_force) {
-            WordsVector vTopLetterCombinationsEmpty;
             emit totalLetterCombinationsCountUpdated(m_totalLetterCombinationsCount);
             emit wordsProcessedCountUpdated(m_wordsProcessed);
-            emit textAnalyzingFinished(vTopLetterCombinationsEmpty);
+            emit textAnalyzingFinished(m_topLetterCombinations);
         }
     }
 }
 
-DictionaryMap CTextAnalyzerWorker::findWordSubstrings(const QString& in_word)
+bool CTextAnalyzerWorker::isShardedDictionaryUsed() const
+{
+    return m_engine == CommonData::elceEnumerator && m_shardedDictionary.shardsCount() > 1;
+}
+
+void CTextAnalyzerWorker::writeResultIndex() const
 {
-    DictionaryMap letterCombinations;
-    for (int i = 0; i < in_word.size(); ++i) {
-        for (int length = CommonData::MinLetterCombinationLength; length <= in_word.size() - i; ++length) {
-            addLetterCombinationToMap(in_word.mid(i, length), letterCombinations);
+    const Tracing::CSpan span("TextAnalyzer::writeResultIndex");
+    CResultIndexWriter resultIndex;
+    if (isShardedDictionaryUsed()) {
+        m_shardedDictionary.forEach([&resultIndex](const char* data, int size, quint64 count){
+            resultIndex.add(data, size, count);
+        });
+    } else {
+        for (quint32 id = 0; id < m_dictionary.size(); ++id) {
+            if (m_letterCombinationsCounts[id]) {
+                resultIndex.add(m_dictionary.data(id), m_dictionary.size(id), m_letterCombinationsCounts[id]);
+            }
         }
     }
-    return letterCombinations;
+    if (!resultIndex.write(m_resultIndexFileName, m_totalLetterCombinationsCount, m_wordsProcessed)) {
+        qWarning("Failed to write the result index.");
+    }
 }
 
-void CTextAnalyzerWorker::addLetterCombinationToMap(const QString& in_word, DictionaryMap& inout_letterCombinations)
+bool CTextAnalyzerWorker::isCheckpointSupported() const
 {
-    if (in_word.length() >= CommonData::MinLetterCombinationLength) {
-        auto hash = qHash(in_word);
-        auto it = inout_letterCombinations.find(hash);
-        if (it == std::end(inout_letterCombinations)) {
-            inout_letterCombinations[hash] = { in_word, 1 };
-        } else {
-            ++it->second.second;
+    return m_checkpoint.isEnabled() && m_engine == CommonData::elceEnumerator && !isShardedDictionaryUsed() && !m_dictionarySpill.runsCount();
+}
+
+void CTextAnalyzerWorker::writeCheckpoint(bool in_isWaiting)
+{
+    const Tracing::CSpan span("TextAnalyzer::writeCheckpoint");
+    m_checkpointTimer.restart();
+    if (!isCheckpointSupported() || m_resumeOffset < 0 || m_resumeOffset == m_checkpointResumeOffset) {
+        return;
+    }
+    if (m_isCheckpointWriting && !in_isWaiting && !m_checkpointWriting.isFinished()) {
+        return;
+    }
+    waitForCheckpoint();
+
+    // Strings of the dictionary are contiguous, so they are copied at once. Words' letter combinations, packed keys and the top
+    // are derived from the dictionary, so they aren't written.
+    auto state = QSharedPointer<SCheckpointState>::create();
+    state->engine = static_cast<qint32>(m_engine);
+    state->minLetterCombinationLength = static_cast<qint32>(m_minLetterCombinationLength);
+    state->maxLetterCombinationLength = static_cast<qint32>(m_maxLetterCombinationLength);
+    state->wordsProcessed = m_wordsProcessed;
+    state->totalLetterCombinationsCount = m_totalLetterCombinationsCount;
+    const quint32 letterCombinationsCount = m_dictionary.size();
+    if (letterCombinationsCount) {
+        const char* lastLetterCombination = m_dictionary.data(letterCombinationsCount - 1);
+        state->letterCombinations.assign(m_dictionary.data(0), lastLetterCombination + m_dictionary.size(letterCombinationsCount - 1));
+    }
+    state->letterCombinationsSizes.resize(letterCombinationsCount);
+    for (quint32 id = 0; id < letterCombinationsCount; ++id) {
+        state->letterCombinationsSizes[id] = m_dictionary.size(id);
+    }
+    state->letterCombinationsCounts = m_letterCombinationsCounts;
+
+    const CCheckpoint checkpoint = m_checkpoint;
+    const qint64 resumeOffset = m_resumeOffset;
+    m_checkpointWriting = QtConcurrent::run([checkpoint, resumeOffset, state](){
+        const Tracing::CSpan span("TextAnalyzer::writeCheckpointFile");
+        return checkpoint.write(resumeOffset, [&state](QDataStream& inout_stream){ writeCheckpointState(*state, inout_stream); });
+    });
+    m_isCheckpointWriting = true;
+    m_checkpointResumeOffset = m_resumeOffset;
+    if (in_isWaiting) {
+        waitForCheckpoint();
+    }
+}
+
+void CTextAnalyzerWorker::waitForCheckpoint()
+{
+    if (!m_isCheckpointWriting) {
+        return;
+    }
+    m_isCheckpointWriting = false;
+    if (!m_checkpointWriting.result()) {
+        qWarning("Failed to write the checkpoint of text analyzing.");
+        // The same state is written again by the next checkpoint.
+        m_checkpointResumeOffset = -1;
+    }
+}
+
+void CTextAnalyzerWorker::writeCheckpointState(const SCheckpointState& in_state, QDataStream& inout_stream)
+{
+    inout_stream << in_state.engine << in_state.minLetterCombinationLength << in_state.maxLetterCombinationLength
+                 << in_state.wordsProcessed << in_state.totalLetterCombinationsCount << static_cast<quint32>(in_state.letterCombinationsSizes.size());
+    const char* letterCombination = in_state.letterCombinations.data();
+    for (size_t i = 0; i < in_state.letterCombinationsSizes.size(); ++i) {
+        const int size = in_state.letterCombinationsSizes[i];
+        inout_stream << QByteArray::fromRawData(letterCombination, size) << in_state.letterCombinationsCounts[i];
+        letterCombination += size;
+    }
+}
+
+bool CTextAnalyzerWorker::readCheckpointState(QDataStream& inout_stream)
+{
+    qint32 engine = 0;
+    qint32 minLetterCombinationLength = 0;
+    qint32 maxLetterCombinationLength = 0;
+    quint32 letterCombinationsCount = 0;
+    inout_stream >> engine >> minLetterCombinationLength >> maxLetterCombinationLength >> m_wordsProcessed >> m_totalLetterCombinationsCount >> letterCombinationsCount;
+    if (inout_stream.status() != QDataStream::Ok || engine != m_engine
+            || minLetterCombinationLength != m_minLetterCombinationLength || maxLetterCombinationLength != m_maxLetterCombinationLength) {
+        return false;
+    }
+
+    auto isBetter = [this](quint32 lhs, quint32 rhs){
+        const quint64 lhsCount = m_letterCombinationsCounts[lhs];
+        const quint64 rhsCount = m_letterCombinationsCounts[rhs];
+        return lhsCount != rhsCount ? lhsCount > rhsCount : m_dictionary.isLess(lhs, rhs);
+    };
+    QByteArray letterCombination;
+    quint64 count = 0;
+    for (quint32 i = 0; i < letterCombinationsCount; ++i) {
+        inout_stream >> letterCombination >> count;
+        if (inout_stream.status() != QDataStream::Ok) {
+            return false;
+        }
+        bool isAdded = false;
+        const quint32 id = m_dictionary.intern(letterCombination.constData(), letterCombination.size(),
+                                               CStringInterner::hash(letterCombination.constData(), letterCombination.size()), isAdded);
+        if (!isAdded) {
+            return false;
+        }
+        m_letterCombinationsCounts.push_back(count);
+        if (letterCombination.size() <= CPackedLetterCombinationsIndex::MaxLength && isPackable(letterCombination.constData(), letterCombination.size())) {
+            m_packedLetterCombinations.insert(CPackedLetterCombinationsIndex::pack(letterCombination.constData(), letterCombination.size()), id);
+        }
+        m_topLetterCombinationsHeap.update(id, isBetter);
+    }
+    return true;
+}
+
+size_t CTextAnalyzerWorker::dictionaryMemoryUsage() const
+{
+    return m_dictionary.memoryUsage() + m_letterCombinationsCounts.size() * (sizeof(quint64) + sizeof(int)) + m_packedLetterCombinations.memoryUsage()
+            + m_wordsCombinationsCache.memoryUsage();
+}
+
+void CTextAnalyzerWorker::spillDictionary()
+{
+    const Tracing::CSpan span("TextAnalyzer::spillDictionary");
+    if (!m_dictionarySpill.writeRun(m_dictionary, m_letterCombinationsCounts)) {
+        // Keep counting in memory, the result is still exact while memory suffices.
+        qWarning("Failed to write letter combinations' counts to disk, spilling is disabled: %s", qUtf8Printable(m_dictionarySpill.errorString()));
+        m_isSpillFailed = true;
+        emit dictionarySpillFailed(m_dictionarySpill.errorString());
+        return;
+    }
+
+    // Identifiers of letter combinations are reset, so letter combinations of words are found again.
+    // Containers are replaced rather than cleared, since clearing keeps their memory, which is what the budget bounds.
+    m_dictionary = CStringInterner();
+    std::vector<quint64>().swap(m_letterCombinationsCounts);
+    m_packedLetterCombinations = CPackedLetterCombinationsIndex();
+    m_wordsCombinationsCache.clear();
+    m_topLetterCombinationsHeap = CTopKHeap(m_topLetterCombinationsCount);
+}
+
+bool CTextAnalyzerWorker::addWordToSpaceSaving(const char* in_word, int in_size, quint64 in_count)
+{
+    // Letter combinations aren't stored per word to keep the memory fixed, so they are enumerated for every batch.
+    bool isTopChanged = false;
+    m_letterCombinationsEnumerator.enumerate(in_word, in_size, m_minLetterCombinationLength, m_maxLetterCombinationLength);
+    for (const auto& letterCombination : m_letterCombinationsEnumerator.letterCombinations()) {
+        if (m_spaceSaving.add(in_word + letterCombination.offset, letterCombination.size, letterCombination.hash, in_count)) {
+            isTopChanged = true;
+        }
+    }
+    m_totalLetterCombinationsCount += static_cast<quint64>(m_letterCombinationsEnumerator.letterCombinations().size()) * in_count;
+    return isTopChanged;
+}
+
+void CTextAnalyzerWorker::addWordToSuffixAutomaton(const char* in_word, int in_size, quint64 in_count)
+{
+    bool isWordAdded = false;
+    const quint32 wordId = m_analyzedWords.intern(in_word, in_size, CStringInterner::hash(in_word, in_size), isWordAdded);
+    if (isWordAdded) {
+        m_codePoints.clear();
+        TextEncoding::AppendCodePoints(in_word, in_size, m_codePoints);
+        const quint32 automatonWordId = m_suffixAutomaton.addWord(m_codePoints.data(), static_cast<int>(m_codePoints.size()));
+        Q_ASSERT(automatonWordId == wordId);
+        Q_UNUSED(automatonWordId);
+    }
+    m_suffixAutomaton.addWordCount(wordId, in_count);
+
+    // The word of N characters has N - L + 1 letter combinations of L characters, their numbers form an arithmetic progression over the lengths' range.
+    const int charactersCount = TextEncoding::CharactersCount(in_word, in_size);
+    const quint64 shortestCombinationsCount = static_cast<quint64>(charactersCount - m_minLetterCombinationLength + 1);
+    const quint64 longestCombinationsCount = static_cast<quint64>(charactersCount - std::min(charactersCount, m_maxLetterCombinationLength) + 1);
+    m_totalLetterCombinationsCount += (shortestCombinationsCount + longestCombinationsCount) * (shortestCombinationsCount - longestCombinationsCount + 1) / 2 * in_count;
+}
+
+void CTextAnalyzerWorker::addWordLetterCombinations(const char* in_word, int in_size)
+{
+    // Short letter combinations of ASCII words are found by packed keys without string hashing and comparison.
+    // Loops are specialized for every packed length at compile time, the runtime lengths' range selects them.
+    m_letterCombinationsIds.clear();
+    int minLength = m_minLetterCombinationLength;
+    if (isPackable(in_word, in_size)) {
+        const int maxPackedLength = std::min({ in_size, m_maxLetterCombinationLength, CPackedLetterCombinationsIndex::MaxLength });
+        for (int length = minLength; length <= maxPackedLength; ++length) {
+            switch (length) {
+            case 1: addPackedLetterCombinations<1>(in_word, in_size); break;
+            case 2: addPackedLetterCombinations<2>(in_word, in_size); break;
+            case 3: addPackedLetterCombinations<3>(in_word, in_size); break;
+            case 4: addPackedLetterCombinations<4>(in_word, in_size); break;
+            case 5: addPackedLetterCombinations<5>(in_word, in_size); break;
+            case 6: addPackedLetterCombinations<6>(in_word, in_size); break;
+            case 7: addPackedLetterCombinations<7>(in_word, in_size); break;
+            case 8: addPackedLetterCombinations<8>(in_word, in_size); break;
+            }
+        }
+        minLength = std::max(minLength, CPackedLetterCombinationsIndex::MaxLength + 1);
+    }
+
+    // Intern the word's remaining letter combinations, the string is copied only when a combination is added to the dictionary.
+    {
+        const AllocationProfiler::CStageScope stage(AllocationProfiler::esEnumerator);
+        m_letterCombinationsEnumerator.enumerate(in_word, in_size, minLength, m_maxLetterCombinationLength);
+    }
+    for (const auto& letterCombination : m_letterCombinationsEnumerator.letterCombinations()) {
+        bool isAdded = false;
+        const quint32 id = m_dictionary.intern(in_word + letterCombination.offset, letterCombination.size, letterCombination.hash, isAdded);
+        if (isAdded) {
+            m_letterCombinationsCounts.push_back(0);
+        }
+        m_letterCombinationsIds.push_back(id);
+    }
+
+    // Store distinct letter combinations of the word with their count in the word.
+    m_wordLetterCombinations.clear();
+    std::sort(std::begin(m_letterCombinationsIds), std::end(m_letterCombinationsIds));
+    for (size_t i = 0; i < m_letterCombinationsIds.size(); ) {
+        size_t next = i + 1;
+        while (next < m_letterCombinationsIds.size() && m_letterCombinationsIds[next] == m_letterCombinationsIds[i]) {
+            ++next;
+        }
+        m_wordLetterCombinations.push_back({ m_letterCombinationsIds[i], static_cast<quint32>(next - i) });
+        i = next;
+    }
+}
+
+template<int Length>
+void CTextAnalyzerWorker::addPackedLetterCombinations(const char* in_word, int in_size)
+{
+    // The key of the next letter combination is obtained from the previous one by shifting in the next byte.
+    quint64 key = CPackedLetterCombinationsIndex::pack<Length>(in_word);
+    for (int offset = 0; ; ++offset) {
+        quint32 id = m_packedLetterCombinations.find(key);
+        if (id == CPackedLetterCombinationsIndex::InvalidId) {
+            bool isAdded = false;
+            id = m_dictionary.intern(in_word + offset, Length, CStringInterner::hash(in_word + offset, Length), isAdded);
+            if (isAdded) {
+                m_letterCombinationsCounts.push_back(0);
+            }
+            m_packedLetterCombinations.insert(key, id);
+        }
+        m_letterCombinationsIds.push_back(id);
+
+        if (offset + Length == in_size) {
+            break;
         }
+        key = CPackedLetterCombinationsIndex::shift<Length>(key, in_word[offset + Length]);
     }
 }
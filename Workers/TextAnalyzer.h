@@ -2,10 +2,26 @@
 #define TEXTANALYZER_H
 
 #include "CommonData.h"
+#include "WordsBatchQueue.h"
+#include "StringInterner.h"
+#include "PackedLetterCombinationsIndex.h"
+#include "LetterCombinationsEnumerator.h"
+#include "TopKHeap.h"
+#include "SuffixAutomaton.h"
+#include "SpaceSaving.h"
+#include "DictionarySpill.h"
+#include "WordsCombinationsCache.h"
+#include "ShardedDictionary.h"
+#include "Checkpoint.h"
+#include "ResultIndex.h"
+#include "PipelineMetrics.h"
 
 #include <QObject>
+#include <QElapsedTimer>
+#include <QFuture>
 #include <QVector>
 #include <QMap>
+#include <QSharedPointer>
 
 class CTextAnalyzerWorker : public QObject
 {
@@ -15,9 +31,86 @@ public:
     CTextAnalyzerWorker();
     ~CTextAnalyzerWorker();
 
+    //! Sets the queue, which passes words batches from the file reader.
+    void setWordsBatchQueue(const QSharedPointer<CWordsBatchQueue>& in_wordsBatchQueue);
+
+    //! Sets the registry of live metrics, which is updated after every words batch. Metrics aren't published if it's null, it's the default.
+    void setPipelineMetrics(const QSharedPointer<CPipelineMetrics>& in_pipelineMetrics);
+
+    //! Sets the range of counted letter combinations' lengths in characters. CommonData::MinLetterCombinationLength and
+    //! CommonData::MaxLetterCombinationLength are used by default. The maximum bounds the work per long token, it's unlimited if it isn't positive.
+    //! It must not be changed while text is being analyzed.
+    void setLetterCombinationsLengthRange(int in_minLength, int in_maxLength);
+
+    //! Sets the number of the most common letter combinations, CommonData::TopLetterCombinationsCount is used by default.
+    //! It must not be changed while text is being analyzed.
+    void setTopLetterCombinationsCount(int in_count);
+
+    //! Sets the letter combinations counting engine from the CommonData::ELetterCombinationsEngine enumeration. The enumerator is used by default.
+    //! The enumerator and the suffix automaton give identical results, the CommonData::elceSpaceSaving engine gives approximate counts
+    //! with error bounds. The engine must not be changed while text is being analyzed.
+    void setEngine(CommonData::ELetterCombinationsEngine in_engine);
+
+    //! Sets the memory budget of the dictionary in bytes in the CommonData::elceEnumerator engine. When the dictionary reaches the budget,
+    //! its counts are written to disk and it's cleared. The exact top is obtained by merging of written counts when text analyzing finishes,
+    //! it isn't updated meanwhile. Spilling is disabled if the budget isn't positive, it's the default.
+    void setSpillMemoryBudget(qint64 in_memoryBudget);
+
+    //! Sets the directory of the dictionary's counts written to disk. The system temporary directory is used by default.
+    void setSpillDirectory(const QString& in_directory);
+
+    //! Sets the number of threads counting letter combinations in the CommonData::elceEnumerator engine. The dictionary is divided into
+    //! the same number of shards. The result is identical to the single-threaded one, which is used if the number is less than two (by default).
+    //! Sharded counting doesn't spill the dictionary to disk. It must not be changed while text is being analyzed.
+    void setShardsCount(int in_shardsCount);
+
+    //! Sets the capacity of the cache of words' letter combinations in the CommonData::elceEnumerator engine in bytes.
+    //! Rarely repeated words are evicted from the full cache. Zero capacity disables the cache. It must not be changed while text is being analyzed.
+    void setWordsCombinationsCacheCapacity(qint64 in_capacity);
+
+    //! Sets the memory budget of the CommonData::elceSpaceSaving engine in bytes. It must not be changed while text is being analyzed.
+    void setApproximationMemoryBudget(qint64 in_memoryBudget);
+
+    //! Sets the file of checkpoints, which are written at most once per the interval and when the words batch queue is closed
+    //! before the whole file is read. Checkpoints are disabled if the name is empty, it's the default. Checkpoints are written
+    //! in the CommonData::elceEnumerator engine unless it's sharded or the dictionary is written to disk.
+    //! Text analyzing stalls only while the dictionary is copied, which takes about a memcpy of its strings and counts
+    //! (the TextAnalyzer::writeCheckpoint span), the copy is written to the file in the background.
+    void setCheckpointFileName(const QString& in_fileName);
+
+    //! Sets the minimum interval between checkpoints in milliseconds, CommonData::CheckpointInterval is used by default.
+    void setCheckpointInterval(int in_interval);
+
+    //! Sets the file to analyze and restores the state from its checkpoint. The state is cleared if there isn't a valid checkpoint
+    //! of the unchanged file. It must be called before text analyzing is started.
+    //! @param out_resumeOffset [out] - the file offset, from which the file reader must resume reading, or zero.
+    //! @return true if the state has been restored.
+    bool resumeFromCheckpoint(const QString& in_sourceFileName, qint64& out_resumeOffset);
+
+    //! Sets the file of the result index, which is written when text analyzing finishes. The index isn't written if the name is empty,
+    //! it's the default. The index contains all letter combinations with exact counts, so it isn't written in the approximate
+    //! CommonData::elceSpaceSaving engine and in the CommonData::elceSuffixAutomaton engine, which doesn't keep letter combinations.
+    //! It isn't written either if the dictionary has been written to disk, because the index would take it back to memory.
+    void setResultIndexFileName(const QString& in_fileName);
+
+    //! Returns the number of distinct letter combinations in memory: dictionary entries in the CommonData::elceEnumerator engine,
+    //! which are only the ones since the last spill if the dictionary is written to disk, tracked letter combinations
+    //! in the CommonData::elceSpaceSaving engine and states in the CommonData::elceSuffixAutomaton engine.
+    //! It's valid until accumulated data are cleared by finishProcessing().
+    quint64 dictionarySize() const;
+
+    //! Returns the approximate memory taken by counted letter combinations in bytes, including the cache of words' letter combinations
+    //! and distinct words of the CommonData::elceSuffixAutomaton engine. It's valid until accumulated data are cleared by finishProcessing().
+    size_t memoryUsage() const;
+
 public slots:
-    //! Analyze the given words, obtains their letter combinations and counts. Add these data into the storage and calculates the most common words' letter combinations.
-    void process(const WordsMap& in_words);
+    //! Resets the words batches queue, restores the state from the checkpoint of the file as resumeFromCheckpoint() does
+    //! and emits resumed() with the resume offset.
+    //! It's invoked in the worker's thread, so the state isn't touched by other threads.
+    void resume(const QString& in_sourceFileName);
+
+    //! Takes words batches from the queue and analyzes them until the file reader closes the queue.
+    void processQueue();
 
     //! Finishes analyzing of remain words.
     void finishTextAnalyzing();
@@ -26,24 +119,115 @@ public slots:
     void finishProcessing();
 
 signals:
+    //! The state has been restored by resume(), the file reader must start reading of the file from the given offset.
+    void resumed(const QString& sourceFileName, qint64 resumeOffset);
+
     void topLetterCombinationsUpdated(const WordsVector&);
+
+    //! The maximum overestimation of counts of the top letter combinations in the CommonData::elceSpaceSaving engine.
+    //! It's emitted before the top letter combinations.
+    void topLetterCombinationsErrorBoundsUpdated(const WordsVector&);
+
+    //! The final top letter combinations. It's emitted when text analyzing finishes, even if the top hasn't changed since the last update.
     void textAnalyzingFinished(const WordsVector&);
     void wordsProcessedCountUpdated(quint64);
     void totalLetterCombinationsCountUpdated(quint64);
 
+    //! Counts of the dictionary couldn't be written to disk. Spilling is disabled until accumulated data are cleared by finishProcessing(),
+    //! the dictionary is counted in memory meanwhile, so the result stays exact while memory suffices.
+    void dictionarySpillFailed(const QString& errorString);
+
+    //! Hits and misses of the cache of words' letter combinations. It's emitted when text analyzing finishes.
+    void wordsCombinationsCacheStatisticsUpdated(quint64 hitsCount, quint64 missesCount);
+
 private:
     //! Analyze the given words, obtains their letter combinations and counts. Add these data into the storage and calculates the most common words' letter combinations.
     //! @param in_force [in] - the parameter is used to finish text analyzing.
-    void processImpl(const WordsMap& in_words, bool in_force = false);
+    void processImpl(const CWordsBatch& in_words, bool in_force = false);
+
+    bool isShardedDictionaryUsed() const;
+
+    //! Writes all letter combinations of the dictionary to the result index.
+    void writeResultIndex() const;
+
+    bool isCheckpointSupported() const;
+
+    //! The analyzer's state copied to write the checkpoint in the background, while counting goes on.
+    struct SCheckpointState
+    {
+        qint32 engine;
+        qint32 minLetterCombinationLength;
+        qint32 maxLetterCombinationLength;
+        quint64 wordsProcessed;
+        quint64 totalLetterCombinationsCount;
+        std::vector<char> letterCombinations;           //!< Letter combinations of the dictionary one after another.
+        std::vector<int> letterCombinationsSizes;
+        std::vector<quint64> letterCombinationsCounts;
+    };
+
+    //! Writes the checkpoint if the state has been changed since the previous one. The state is copied and written in the background.
+    //! The checkpoint is skipped if the previous one is still being written.
+    //! @param in_isWaiting [in] - waits for the previous checkpoint and for this one to be written.
+    void writeCheckpoint(bool in_isWaiting = false);
+
+    //! Waits until the checkpoint being written in the background is written.
+    void waitForCheckpoint();
+
+    static void writeCheckpointState(const SCheckpointState& in_state, QDataStream& inout_stream);
+    bool readCheckpointState(QDataStream& inout_stream);
+
+    //! Returns the approximate memory taken by the dictionary and letter combinations of words in bytes.
+    size_t dictionaryMemoryUsage() const;
+
+    //! Writes counts of the dictionary to disk and clears it, its memory is released.
+    void spillDictionary();
+
+    //! Adds letter combinations of the word to the approximate counters.
+    //! @return true if the top letter combinations may have been changed.
+    bool addWordToSpaceSaving(const char* in_word, int in_size, quint64 in_count);
+
+    //! Adds the word to the suffix automaton and counts its letter combinations in the total count.
+    void addWordToSuffixAutomaton(const char* in_word, int in_size, quint64 in_count);
+
+    //! Adds letter combinations of the given word to the dictionary and stores its distinct letter combinations in m_wordLetterCombinations.
+    void addWordLetterCombinations(const char* in_word, int in_size);
 
-    DictionaryMap findWordSubstrings(const QString& in_word);
-    void addLetterCombinationToMap(const QString& in_word, DictionaryMap& inout_letterCombinations);
+    //! Adds letter combinations of the given length of the ASCII word to the dictionary by their packed keys and stores their identifiers
+    //! in m_letterCombinationsIds. The word mustn't be shorter than the letter combinations.
+    template<int Length>
+    void addPackedLetterCombinations(const char* in_word, int in_size);
 
-    DictionaryMap m_dictionary;                             //!< Store the dictionary in memory. For analyzing huge files should store the dictionary in file system.
-    WordsLetterCombinationsMap m_wordsLetterCombinations;   //!< Contains letter combinations hashes and their count in words (in hash representation).
+    QSharedPointer<CWordsBatchQueue> m_wordsBatchQueue;
+    QSharedPointer<CPipelineMetrics> m_pipelineMetrics;
+    CommonData::ELetterCombinationsEngine m_engine { CommonData::elceEnumerator };
+    int m_minLetterCombinationLength { CommonData::MinLetterCombinationLength };
+    int m_maxLetterCombinationLength { CommonData::MaxLetterCombinationLength };
+    int m_topLetterCombinationsCount { CommonData::TopLetterCombinationsCount };
+    CSuffixAutomaton m_suffixAutomaton;                     //!< Distinct words in the CommonData::elceSuffixAutomaton engine.
+    CSpaceSaving m_spaceSaving;                             //!< Approximate counters in the CommonData::elceSpaceSaving engine.
+    CDictionarySpill m_dictionarySpill;                     //!< Counts of the dictionary written to disk.
+    CShardedDictionary m_shardedDictionary;                 //!< The dictionary divided into shards, which are counted in parallel.
+    qint64 m_spillMemoryBudget { 0 };
+    bool m_isSpillFailed { false };                         //!< Spilling is disabled after the failed write until finishProcessing().
+    CStringInterner m_dictionary;                           //!< Store the dictionary in memory. For analyzing huge files should store the dictionary in file system.
+    std::vector<quint64> m_letterCombinationsCounts;        //!< Letter combinations' counts indexed by identifiers in the dictionary.
+    CPackedLetterCombinationsIndex m_packedLetterCombinations;  //!< Identifiers of short ASCII letter combinations in the dictionary.
+    CStringInterner m_analyzedWords;                        //!< Distinct words. Their letter combinations are stored in the suffix automaton.
+    CWordsCombinationsCache m_wordsCombinationsCache;       //!< Letter combinations of repeated words.
+    std::vector<CWordsCombinationsCache::SLetterCombination> m_wordLetterCombinations;  //!< Distinct letter combinations of the word being analyzed.
     WordsVector m_topLetterCombinations;                    //!< The current top letter combinations.
-    quint64 m_topLetterCombinationsMinCount { 0 };          //!< The minimum letter combinations count in the most common words' letter combinations.
-                                                            //!< It's used to check need to sort the dictionary and update letter combinations.
+    CTopKHeap m_topLetterCombinationsHeap;                  //!< Identifiers of the most common letter combinations. It's updated on every count change.
+    CLetterCombinationsEnumerator m_letterCombinationsEnumerator;
+    std::vector<quint32> m_letterCombinationsIds;           //!< The buffer of letter combinations' identifiers.
+    std::vector<uint> m_codePoints;                         //!< Code points of the word being added to the suffix automaton.
+    QString m_resultIndexFileName;
+    CCheckpoint m_checkpoint;
+    int m_checkpointInterval { CommonData::CheckpointInterval };
+    QElapsedTimer m_checkpointTimer;
+    qint64 m_resumeOffset { -1 };                           //!< The resume offset of the last counted batch.
+    qint64 m_checkpointResumeOffset { -1 };                 //!< The resume offset of the last written checkpoint.
+    QFuture<bool> m_checkpointWriting;                      //!< The checkpoint being written in the background.
+    bool m_isCheckpointWriting { false };
     quint64 m_wordsProcessed { 0 };
     quint64 m_totalLetterCombinationsCount { 0 };
 };
@@ -0,0 +1,233 @@
+#include "TextEncoding.h"
+
+#include <QChar>
+
+#include <algorithm>
+
+namespace {
+
+    // The size of the text beginning, which is checked to be valid UTF-8.
+    constexpr qint64 DetectionSampleSize = 64 * 1024;
+
+    //! Checks if the given data is valid UTF-8. Overlong forms, surrogates and code points above U+10FFFF are invalid.
+    //! @param in_isTruncated [in] - the data is a part of the text, so the last sequence may be incomplete.
+    bool isValidUtf8(const uchar* in_data, qint64 in_size, bool in_isTruncated)
+    {
+        qint64 i = 0;
+        while (i < in_size) {
+            const uchar lead = in_data[i];
+            if (lead < 0x80) {
+                ++i;
+                continue;
+            }
+
+            int length = 0;
+            uchar secondByteMin = 0x80, secondByteMax = 0xBF;
+            if (lead >= 0xC2 && lead <= 0xDF) {
+                length = 2;
+            } else if (lead >= 0xE0 && lead <= 0xEF) {
+                length = 3;
+                if (lead == 0xE0) {
+                    secondByteMin = 0xA0;
+                } else if (lead == 0xED) {
+                    secondByteMax = 0x9F;
+                }
+            } else if (lead >= 0xF0 && lead <= 0xF4) {
+                length = 4;
+                if (lead == 0xF0) {
+                    secondByteMin = 0x90;
+                } else if (lead == 0xF4) {
+                    secondByteMax = 0x8F;
+                }
+            } else {
+                return false;
+            }
+
+            if (i + length > in_size) {
+                return in_isTruncated;
+            }
+            if (in_data[i + 1] < secondByteMin || in_data[i + 1] > secondByteMax) {
+                return false;
+            }
+            for (int j = 2; j < length; ++j) {
+                if ((in_data[i + j] & 0xC0) != 0x80) {
+                    return false;
+                }
+            }
+            i += length;
+        }
+        return true;
+    }
+
+} // namespace
+
+namespace TextEncoding {
+
+    CommonData::ETextEncoding DetectEncoding(const char* in_data, qint64 in_size, int& out_bomSize)
+    {
+        const uchar* data = reinterpret_cast<const uchar*>(in_data);
+        out_bomSize = 0;
+        if (in_size >= 3 && data[0] == 0xEF && data[1] == 0xBB && data[2] == 0xBF) {
+            out_bomSize = 3;
+            return CommonData::eteUtf8;
+        }
+        if (in_size >= 2 && data[0] == 0xFF && data[1] == 0xFE) {
+            out_bomSize = 2;
+            return CommonData::eteUtf16LittleEndian;
+        }
+        if (in_size >= 2 && data[0] == 0xFE && data[1] == 0xFF) {
+            out_bomSize = 2;
+            return CommonData::eteUtf16BigEndian;
+        }
+        const qint64 sampleSize = std::min(in_size, DetectionSampleSize);
+        return isValidUtf8(data, sampleSize, sampleSize < in_size) ? CommonData::eteUtf8 : CommonData::eteLatin1;
+    }
+
+    void AppendLowerCase(const char* in_data, int in_size, QByteArray& inout_result)
+    {
+        // ASCII fast path: the ASCII head of the text is converted without decoding.
+        int asciiSize = 0;
+        while (asciiSize < in_size && static_cast<uchar>(in_data[asciiSize]) < 0x80) {
+            ++asciiSize;
+        }
+        if (asciiSize) {
+            const int resultSize = inout_result.size();
+            inout_result.resize(resultSize + asciiSize);
+            char* result = inout_result.data() + resultSize;
+            for (int i = 0; i < asciiSize; ++i) {
+                const char c = in_data[i];
+                result[i] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
+            }
+        }
+
+        int i = asciiSize;
+        while (i < in_size) {
+            const uchar lead = static_cast<uchar>(in_data[i]);
+            if (lead < 0x80) {
+                inout_result.append((lead >= 'A' && lead <= 'Z') ? static_cast<char>(lead | 0x20) : static_cast<char>(lead));
+                ++i;
+                continue;
+            }
+            const int length = lead >= 0xF0 ? 4 : (lead >= 0xE0 ? 3 : 2);
+            uint codePoint = lead & (0x7F >> length);
+            for (int j = 1; j < length && i + j < in_size; ++j) {
+                codePoint = (codePoint << 6) | (static_cast<uchar>(in_data[i + j]) & 0x3F);
+            }
+            AppendUtf8(QChar::toLower(codePoint), inout_result);
+            i += length;
+        }
+    }
+
+    void AppendCodePoints(const char* in_data, int in_size, std::vector<uint>& inout_result)
+    {
+        int i = 0;
+        while (i < in_size) {
+            const uchar lead = static_cast<uchar>(in_data[i]);
+            if (lead < 0x80) {
+                inout_result.push_back(lead);
+                ++i;
+                continue;
+            }
+            const int length = lead >= 0xF0 ? 4 : (lead >= 0xE0 ? 3 : 2);
+            uint codePoint = lead & (0x7F >> length);
+            for (int j = 1; j < length && i + j < in_size; ++j) {
+                codePoint = (codePoint << 6) | (static_cast<uchar>(in_data[i + j]) & 0x3F);
+            }
+            inout_result.push_back(codePoint);
+            i += length;
+        }
+    }
+
+    void AppendUtf8(uint in_codePoint, QByteArray& inout_result)
+    {
+        if (in_codePoint < 0x80) {
+            inout_result.append(static_cast<char>(in_codePoint));
+        } else if (in_codePoint < 0x800) {
+            inout_result.append(static_cast<char>(0xC0 | (in_codePoint >> 6)));
+            inout_result.append(static_cast<char>(0x80 | (in_codePoint & 0x3F)));
+        } else if (in_codePoint < 0x10000) {
+            inout_result.append(static_cast<char>(0xE0 | (in_codePoint >> 12)));
+            inout_result.append(static_cast<char>(0x80 | ((in_codePoint >> 6) & 0x3F)));
+            inout_result.append(static_cast<char>(0x80 | (in_codePoint & 0x3F)));
+        } else {
+            inout_result.append(static_cast<char>(0xF0 | (in_codePoint >> 18)));
+            inout_result.append(static_cast<char>(0x80 | ((in_codePoint >> 12) & 0x3F)));
+            inout_result.append(static_cast<char>(0x80 | ((in_codePoint >> 6) & 0x3F)));
+            inout_result.append(static_cast<char>(0x80 | (in_codePoint & 0x3F)));
+        }
+    }
+
+} // namespace TextEncoding
+
+CUtf8Transcoder::CUtf8Transcoder(CommonData::ETextEncoding in_encoding)
+    : m_encoding(in_encoding)
+{}
+
+void CUtf8Transcoder::setEncoding(CommonData::ETextEncoding in_encoding)
+{
+    m_encoding = in_encoding;
+    reset();
+}
+
+void CUtf8Transcoder::transcode(const char* in_data, qint64 in_size, QByteArray& inout_result)
+{
+    const uchar* data = reinterpret_cast<const uchar*>(in_data);
+    switch (m_encoding) {
+    case CommonData::eteUtf8:
+        inout_result.append(in_data, static_cast<int>(in_size));
+        break;
+    case CommonData::eteLatin1:
+        for (qint64 i = 0; i < in_size; ++i) {
+            TextEncoding::AppendUtf8(data[i], inout_result);
+        }
+        break;
+    case CommonData::eteUtf16LittleEndian:
+    case CommonData::eteUtf16BigEndian: {
+        const bool isLittleEndian = m_encoding == CommonData::eteUtf16LittleEndian;
+        auto codeUnit = [isLittleEndian](uchar in_first, uchar in_second) {
+            return static_cast<quint16>(isLittleEndian ? (in_first | (in_second << 8)) : ((in_first << 8) | in_second));
+        };
+        qint64 i = 0;
+        if (m_hasPendingByte && in_size > 0) {
+            appendUtf16CodeUnit(codeUnit(m_pendingByte, data[0]), inout_result);
+            m_hasPendingByte = false;
+            i = 1;
+        }
+        for (; i + 1 < in_size; i += 2) {
+            appendUtf16CodeUnit(codeUnit(data[i], data[i + 1]), inout_result);
+        }
+        if (i < in_size) {
+            m_pendingByte = data[i];
+            m_hasPendingByte = true;
+        }
+        break;
+    }
+    }
+}
+
+void CUtf8Transcoder::reset()
+{
+    m_highSurrogate = 0;
+    m_pendingByte = 0;
+    m_hasPendingByte = false;
+}
+
+void CUtf8Transcoder::appendUtf16CodeUnit(quint16 in_codeUnit, QByteArray& inout_result)
+{
+    const bool isHighSurrogate = in_codeUnit >= 0xD800 && in_codeUnit <= 0xDBFF;
+    const bool isLowSurrogate = in_codeUnit >= 0xDC00 && in_codeUnit <= 0xDFFF;
+    if (m_highSurrogate) {
+        if (isLowSurrogate) {
+            TextEncoding::AppendUtf8(0x10000 + ((m_highSurrogate - 0xD800) << 10) + (in_codeUnit - 0xDC00), inout_result);
+            m_highSurrogate = 0;
+            return;
+        }
+        TextEncoding::AppendUtf8(QChar::ReplacementCharacter, inout_result);
+        m_highSurrogate = 0;
+    }
+    if (isHighSurrogate) {
+        m_highSurrogate = in_codeUnit;
+    } else {
+        TextEncoding::AppendUtf8(isLowSurrogate ? static_cast<uint>(QChar::ReplacementCharacter) : in_codeUnit, inout_result);
+    }
+}
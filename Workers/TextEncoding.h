@@ -0,0 +1,70 @@
+#ifndef TEXTENCODING_H
+#define TEXTENCODING_H
+
+#include "CommonData.h"
+
+#include <QByteArray>
+
+#include <vector>
+
+namespace TextEncoding {
+
+    //! Detects the text encoding by the byte order mark. Text without the byte order mark is UTF-8 if its beginning is valid UTF-8,
+    //! otherwise it's Latin-1.
+    //! @param out_bomSize [out] - the byte order mark size, which should be skipped.
+    CommonData::ETextEncoding DetectEncoding(const char* in_data, qint64 in_size, int& out_bomSize);
+
+    //! Appends the given valid UTF-8 text converted to lowercase to the result.
+    //! ASCII characters are converted in place, other characters are converted by the simple Unicode case mapping.
+    void AppendLowerCase(const char* in_data, int in_size, QByteArray& inout_result);
+
+    //! Appends code points of the given valid UTF-8 text to the result.
+    void AppendCodePoints(const char* in_data, int in_size, std::vector<uint>& inout_result);
+
+    //! Appends the given code point encoded in UTF-8 to the result.
+    void AppendUtf8(uint in_codePoint, QByteArray& inout_result);
+
+    //! Checks if the given byte begins a character in UTF-8 text.
+    inline bool IsCharacterBegin(char in_byte)
+    {
+        return (static_cast<uchar>(in_byte) & 0xC0) != 0x80;
+    }
+
+    //! Returns the number of characters in the given valid UTF-8 text.
+    inline int CharactersCount(const char* in_data, int in_size)
+    {
+        int count = 0;
+        for (int i = 0; i < in_size; ++i) {
+            count += IsCharacterBegin(in_data[i]);
+        }
+        return count;
+    }
+
+} // namespace TextEncoding
+
+//! The CUtf8Transcoder class converts Latin-1 and UTF-16 text to UTF-8. The text may be converted by chunks of any size:
+//! a character divided by chunks' boundary is kept in the transcoder until the next chunk.
+class CUtf8Transcoder
+{
+public:
+    explicit CUtf8Transcoder(CommonData::ETextEncoding in_encoding = CommonData::eteLatin1);
+
+    void setEncoding(CommonData::ETextEncoding in_encoding);
+    CommonData::ETextEncoding encoding() const { return m_encoding; }
+
+    //! Appends the given chunk converted to UTF-8 to the result. Unpaired surrogates are converted to the replacement character.
+    void transcode(const char* in_data, qint64 in_size, QByteArray& inout_result);
+
+    //! Drops the pending character.
+    void reset();
+
+private:
+    void appendUtf16CodeUnit(quint16 in_codeUnit, QByteArray& inout_result);
+
+    CommonData::ETextEncoding m_encoding;
+    quint16 m_highSurrogate { 0 };
+    uchar m_pendingByte { 0 };
+    bool m_hasPendingByte { false };
+};
+
+#endif // TEXTENCODING_H
@@ -0,0 +1,133 @@
+#ifndef TOPKHEAP_H
+#define TOPKHEAP_H
+
+#include <QtGlobal>
+
+#include <algorithm>
+#include <vector>
+
+//! The CTopKHeap class maintains identifiers of the K best elements, which values only grow, e.g. counts.
+//! It's an indexed min-heap: the root is the worst element of the top, and positions of elements in the heap are indexed by identifiers,
+//! so an updated element is found in constant time and moved in O(log K) time regardless of the number of elements.
+//! The order is given by the predicate isBetter(lhsId, rhsId), which must be a strict total order for deterministic results.
+class CTopKHeap
+{
+public:
+    explicit CTopKHeap(int in_capacity) : m_capacity(in_capacity) {}
+
+    //! Sets the number of elements in the top and removes all elements.
+    void setCapacity(int in_capacity)
+    {
+        m_capacity = in_capacity;
+        clear();
+    }
+
+    //! Removes all elements.
+    void clear()
+    {
+        m_heap.clear();
+        m_positions.clear();
+    }
+
+    //! Updates the top after the element's value has grown.
+    //! @return true if the element is in the top.
+    template<typename IsBetter>
+    bool update(quint32 in_id, IsBetter in_isBetter)
+    {
+        if (in_id >= m_positions.size()) {
+            m_positions.resize(in_id + 1, NotInHeap);
+        }
+        int position = m_positions[in_id];
+        if (position == NotInHeap) {
+            if (static_cast<int>(m_heap.size()) < m_capacity) {
+                m_heap.push_back(in_id);
+                position = static_cast<int>(m_heap.size()) - 1;
+                m_positions[in_id] = position;
+                siftUp(position, in_isBetter);
+                return true;
+            }
+            if (m_heap.empty() || !in_isBetter(in_id, m_heap.front())) {
+                return false;
+            }
+
+            // The element replaces the worst element of the top.
+            m_positions[m_heap.front()] = NotInHeap;
+            m_heap.front() = in_id;
+            m_positions[in_id] = 0;
+            position = 0;
+        }
+        siftDown(position, in_isBetter);
+        return true;
+    }
+
+    //! Returns identifiers of the top in arbitrary order.
+    const std::vector<quint32>& ids() const { return m_heap; }
+
+    //! Returns identifiers of the top from the best to the worst.
+    template<typename IsBetter>
+    std::vector<quint32> sortedIds(IsBetter in_isBetter) const
+    {
+        std::vector<quint32> result(m_heap);
+        std::sort(std::begin(result), std::end(result), in_isBetter);
+        return result;
+    }
+
+    int size() const { return static_cast<int>(m_heap.size()); }
+    bool isFull() const { return static_cast<int>(m_heap.size()) >= m_capacity; }
+
+    //! Returns the worst element of the top. The top must not be empty.
+    quint32 worstId() const { return m_heap.front(); }
+
+private:
+    static constexpr int NotInHeap = -1;
+
+    template<typename IsBetter>
+    void siftUp(int in_position, IsBetter in_isBetter)
+    {
+        const quint32 id = m_heap[in_position];
+        while (in_position > 0) {
+            const int parent = (in_position - 1) / 2;
+            if (!in_isBetter(m_heap[parent], id)) {
+                break;
+            }
+            place(in_position, m_heap[parent]);
+            in_position = parent;
+        }
+        place(in_position, id);
+    }
+
+    //! Moves the improved element down, the worse children take its place.
+    template<typename IsBetter>
+    void siftDown(int in_position, IsBetter in_isBetter)
+    {
+        const quint32 id = m_heap[in_position];
+        const int size = static_cast<int>(m_heap.size());
+        for (;;) {
+            int child = 2 * in_position + 1;
+            if (child >= size) {
+                break;
+            }
+            if (child + 1 < size && in_isBetter(m_heap[child], m_heap[child + 1])) {
+                ++child;
+            }
+            if (!in_isBetter(id, m_heap[child])) {
+                break;
+            }
+            place(in_position, m_heap[child]);
+            in_position = child;
+        }
+        place(in_position, id);
+    }
+
+    void place(int in_position, quint32 in_id)
+    {
+        m_heap[in_position] = in_id;
+        m_positions[in_id] = in_position;
+    }
+
+    int m_capacity;
+    std::vector<quint32> m_heap;        //!< Identifiers, the parent is never better than its children.
+    std::vector<int> m_positions;       //!< Positions of elements in the heap indexed by identifiers, NotInHeap for elements out of the top.
+};
+
+#endif // TOPKHEAP_H
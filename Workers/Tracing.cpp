@@ -0,0 +1,183 @@
+#include "Tracing.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QMutex>
+#include <QThread>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace {
+
+    struct SSpan
+    {
+        const char* name;
+        qint64 startTime;
+        qint64 duration;
+    };
+
+    //! Spans are appended to fixed-size chunks, so recorded spans never move and the writer reads them while the thread records new ones.
+    //! The chunk's size is published after its span is written.
+    struct SChunk
+    {
+        static constexpr int Capacity = 4096;
+
+        SSpan spans[Capacity];
+        std::atomic<int> size { 0 };
+        std::atomic<SChunk*> next { nullptr };
+    };
+
+    //! Spans of one thread. The buffer outlives its thread, so spans of finished threads are written too.
+    struct SThreadBuffer
+    {
+        ~SThreadBuffer()
+        {
+            for (SChunk* chunk = first.get()->next.load(); chunk; ) {
+                SChunk* next = chunk->next.load();
+                delete chunk;
+                chunk = next;
+            }
+        }
+
+        int id { 0 };
+        QString name;
+        std::unique_ptr<SChunk> first { new SChunk() };
+        SChunk* last { first.get() };   //!< The chunk being filled. It's accessed by the buffer's thread only.
+        int spansCount { 0 };           //!< It's accessed by the buffer's thread only.
+    };
+
+    //! Buffers of all threads, which have recorded spans. The mutex guards registration of threads and writing only.
+    struct SRegistry
+    {
+        QMutex mutex;
+        std::vector<std::unique_ptr<SThreadBuffer>> buffers;
+        const std::chrono::steady_clock::time_point startTime { std::chrono::steady_clock::now() };
+    };
+
+    SRegistry& registry()
+    {
+        static SRegistry registry;
+        return registry;
+    }
+
+    thread_local SThreadBuffer* threadBuffer = nullptr;
+
+    //! Returns the buffer of the calling thread, it's registered by the first span of the thread.
+    SThreadBuffer& currentThreadBuffer()
+    {
+        if (!threadBuffer) {
+            auto buffer = std::make_unique<SThreadBuffer>();
+            const QThread* thread = QThread::currentThread();
+            if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+                buffer->name = "Main thread";
+            } else if (thread && !thread->objectName().isEmpty()) {
+                buffer->name = thread->objectName();
+            }
+
+            SRegistry& spansRegistry = registry();
+            QMutexLocker locker(&spansRegistry.mutex);
+            buffer->id = static_cast<int>(spansRegistry.buffers.size()) + 1;
+            if (buffer->name.isEmpty()) {
+                buffer->name = QString("Thread %1").arg(buffer->id);
+            }
+            threadBuffer = buffer.get();
+            spansRegistry.buffers.push_back(std::move(buffer));
+        }
+        return *threadBuffer;
+    }
+
+    //! Escapes the string for a JSON string literal.
+    QByteArray escaped(const QByteArray& in_string)
+    {
+        QByteArray result;
+        for (const char character : in_string) {
+            if (character == '"' || character == '\\') {
+                result.append('\\');
+            }
+            if (static_cast<uchar>(character) >= 0x20) {
+                result.append(character);
+            }
+        }
+        return result;
+    }
+
+} // namespace
+
+namespace Tracing {
+
+    void SetEnabled(bool in_isEnabled)
+    {
+        // The registry is created before the first span, so its start time precedes all spans.
+        registry();
+        IsEnabledFlag.store(in_isEnabled, std::memory_order_relaxed);
+    }
+
+    qint64 Now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - registry().startTime).count();
+    }
+
+    void Record(const char* in_name, qint64 in_startTime)
+    {
+        const qint64 endTime = Now();
+        SThreadBuffer& buffer = currentThreadBuffer();
+        if (buffer.spansCount == MaxThreadSpansCount) {
+            return;
+        }
+
+        SChunk* chunk = buffer.last;
+        int size = chunk->size.load(std::memory_order_relaxed);
+        if (size == SChunk::Capacity) {
+            chunk = new SChunk();
+            buffer.last->next.store(chunk, std::memory_order_release);
+            buffer.last = chunk;
+            size = 0;
+        }
+        chunk->spans[size] = { in_name, in_startTime, endTime - in_startTime };
+        chunk->size.store(size + 1, std::memory_order_release);
+        ++buffer.spansCount;
+    }
+
+    bool Write(const QString& in_fileName)
+    {
+        QFile file(in_fileName);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            return false;
+        }
+
+        // Complete events ("X") are written with times in microseconds, threads are named by metadata events ("M").
+        SRegistry& spansRegistry = registry();
+        QMutexLocker locker(&spansRegistry.mutex);
+        QByteArray events;
+        bool isFirstEvent = true;
+        auto appendEvent = [&events, &isFirstEvent](const QByteArray& in_event){
+            events.append(isFirstEvent ? "\n" : ",\n").append(in_event);
+            isFirstEvent = false;
+        };
+        file.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+        for (const auto& buffer : spansRegistry.buffers) {
+            appendEvent(QString("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%1,\"args\":{\"name\":\"%2\"}}")
+                        .arg(buffer->id).arg(QString::fromUtf8(escaped(buffer->name.toUtf8()))).toUtf8());
+            for (const SChunk* chunk = buffer->first.get(); chunk; chunk = chunk->next.load(std::memory_order_acquire)) {
+                const int size = chunk->size.load(std::memory_order_acquire);
+                for (int i = 0; i < size; ++i) {
+                    const SSpan& span = chunk->spans[i];
+                    appendEvent(QString("{\"name\":\"%1\",\"ph\":\"X\",\"pid\":1,\"tid\":%2,\"ts\":%3,\"dur\":%4}")
+                                .arg(QString::fromUtf8(escaped(span.name))).arg(buffer->id)
+                                .arg(span.startTime / 1000.0, 0, 'f', 3).arg(span.duration / 1000.0, 0, 'f', 3).toUtf8());
+                }
+                if (events.size() >= 1024 * 1024) {
+                    file.write(events);
+                    events.resize(0);
+                }
+            }
+        }
+        events.append("\n]}\n");
+        file.write(events);
+        file.close();
+        return file.error() == QFileDevice::NoError;
+    }
+
+} // namespace Tracing
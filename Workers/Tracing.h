@@ -0,0 +1,60 @@
+#ifndef TRACING_H
+#define TRACING_H
+
+#include <QtGlobal>
+#include <QString>
+
+#include <atomic>
+
+//! Timeline tracing of the pipeline's threads. Spans are recorded to per-thread buffers without locks and written as Chrome trace-event JSON,
+//! which is opened by chrome://tracing or Perfetto. Tracing is disabled by default, a span costs one relaxed atomic load then.
+namespace Tracing {
+
+    //! The maximum number of spans recorded by a thread. Later spans of the thread are dropped.
+    inline constexpr int MaxThreadSpansCount = 1 << 20;
+
+    inline std::atomic<bool> IsEnabledFlag { false };
+
+    inline bool IsEnabled() { return IsEnabledFlag.load(std::memory_order_relaxed); }
+
+    //! Enables or disables recording of spans. Recorded spans are kept.
+    void SetEnabled(bool in_isEnabled);
+
+    //! Returns the monotonic time in nanoseconds since the start of tracing.
+    qint64 Now();
+
+    //! Records the span of the calling thread, which started at the given time and ends now.
+    //! @param in_name [in] - the span's name, it must be a string literal or live until spans are written.
+    void Record(const char* in_name, qint64 in_startTime);
+
+    //! Writes spans recorded by all threads to the file in Chrome trace-event JSON. Threads may record spans meanwhile.
+    //! @return false if the file couldn't be written.
+    bool Write(const QString& in_fileName);
+
+    //! The CSpan class records the span of its scope if tracing is enabled when the span is created.
+    class CSpan
+    {
+    public:
+        explicit CSpan(const char* in_name)
+            : m_name(in_name)
+            , m_startTime(IsEnabled() ? Now() : -1)
+        {}
+
+        ~CSpan()
+        {
+            if (m_startTime >= 0) {
+                Record(m_name, m_startTime);
+            }
+        }
+
+        CSpan(const CSpan&) = delete;
+        CSpan& operator=(const CSpan&) = delete;
+
+    private:
+        const char* m_name;
+        qint64 m_startTime;
+    };
+
+} // namespace Tracing
+
+#endif // TRACING_H
@@ -0,0 +1,116 @@
+#include "WordTokenizer.h"
+
+#include <QChar>
+
+// Byte classes:
+//  0 - 00..7F,  1 - 80..8F,  2 - 90..9F,  3 - A0..BF,  4 - C0..C1 and F5..FF (invalid),  5 - C2..DF,
+//  6 - E0,      7 - E1..EC and EE..EF,      8 - ED,      9 - F0,      10 - F1..F3,      11 - F4.
+const uchar CWordTokenizer::s_byteClasses[256] = {
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+     2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,
+     3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,
+     3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,
+     4,  4,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     6,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  8,  7,  7,
+     9, 10, 10, 10, 11,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4
+};
+
+const uchar CWordTokenizer::s_leadByteMasks[] = {
+    0x7F, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x0F, 0x0F, 0x0F, 0x07, 0x07, 0x07
+};
+
+// Overlong forms, surrogates and code points above U+10FFFF are rejected.
+const uchar CWordTokenizer::s_utf8Transitions[] = {
+    0, 1, 1, 1, 1, 2, 5, 3, 6, 7, 4, 8,   // eusAccept
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,   // eusReject
+    1, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,   // Expect 1 continuation byte
+    1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1,   // Expect 2 continuation bytes
+    1, 3, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1,   // Expect 3 continuation bytes
+    1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1,   // After E0: expect A0..BF
+    1, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1,   // After ED: expect 80..9F
+    1, 1, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1,   // After F0: expect 90..BF
+    1, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1    // After F4: expect 80..8F
+};
+
+const uchar CWordTokenizer::s_asciiSeparators[128] = {
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  1,  1,  1,  1,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  1,  1,  1,  1,  1,
+     1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  1,  1,  1,  1,
+     1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  1,  1,  1,  0
+};
+
+CWordTokenizer::SeparatorsTable CWordTokenizer::buildSeparatorsTable()
+{
+    SeparatorsTable separators {};
+    for (uint codePoint = 128; codePoint <= MaxCodePoint; ++codePoint) {
+        if (QChar::isSpace(codePoint) || QChar::isPunct(codePoint) || QChar::isSymbol(codePoint)) {
+            separators[codePoint >> 6] |= quint64(1) << (codePoint & 63);
+        }
+    }
+    return separators;
+}
+
+CWordTokenizer::CWordTokenizer()
+{
+    m_pending.reserve(256);
+}
+
+void CWordTokenizer::reset()
+{
+    m_pending.resize(0);
+    m_pendingSequenceSize = 0;
+    m_codePoint = 0;
+    m_utf8State = eusAccept;
+    m_isInWord = false;
+}
+
+qint64 CWordTokenizer::findWordBoundary(const char* in_data, qint64 in_size, qint64 in_from)
+{
+    qint64 offset = in_from;
+    while (offset < in_size) {
+        const uchar lead = static_cast<uchar>(in_data[offset]);
+        if (lead < 128) {
+            if (s_asciiSeparators[lead]) {
+                return offset;
+            }
+            ++offset;
+            continue;
+        }
+
+        // A continuation byte may be in the middle of a character.
+        const uchar leadClass = s_byteClasses[lead];
+        if (leadClass >= 1 && leadClass <= 3) {
+            ++offset;
+            continue;
+        }
+
+        // Decode the sequence the same way as feed() does. An invalid sequence is the replacement character, which is a separator.
+        uint codePoint = lead & s_leadByteMasks[leadClass];
+        uchar state = s_utf8Transitions[leadClass];
+        qint64 length = 1;
+        while (state != eusAccept && state != eusReject && offset + length < in_size) {
+            const uchar byte = static_cast<uchar>(in_data[offset + length]);
+            state = s_utf8Transitions[state * 12 + s_byteClasses[byte]];
+            codePoint = (codePoint << 6) | (byte & 0x3F);
+            ++length;
+        }
+        if (state != eusAccept || isSeparator(codePoint)) {
+            return offset;
+        }
+        offset += length;
+    }
+    return in_size;
+}
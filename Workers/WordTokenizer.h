@@ -0,0 +1,188 @@
+#ifndef WORDTOKENIZER_H
+#define WORDTOKENIZER_H
+
+#include <QByteArray>
+#include <QChar>
+
+#include <array>
+
+//! The CWordTokenizer class splits UTF-8 text to individual words divided by whitespace and punctuation characters.
+//! The tokenizer is a table-driven state machine: UTF-8 sequences are decoded by the byte classes and transitions tables
+//! and decoded characters are classified by the precomputed Unicode separators table.
+//! The tokenizer is resumable: the text may be fed by chunks of any size, a word divided by chunks' boundary is kept
+//! in the tokenizer and reported when it's completed.
+class CWordTokenizer
+{
+public:
+    CWordTokenizer();
+
+    //! Splits the given chunk of UTF-8 text and calls the handler for each completed word.
+    //! @param in_onWord [in] - the handler with the (const char* data, int size) signature.
+    //!                         The word data is valid only during the call, words aren't copied unless they are divided by chunks.
+    template <typename TWordHandler>
+    void feed(const char* in_data, qint64 in_size, TWordHandler&& in_onWord);
+
+    //! Finishes the text and reports the last word, if any. The tokenizer is ready for a new text afterwards.
+    template <typename TWordHandler>
+    void finish(TWordHandler&& in_onWord);
+
+    //! Drops the pending word and decoding state.
+    void reset();
+
+    //! Finds the first separator character beginning at or after the given offset. The text may be split there
+    //! into parts, which are tokenized independently with the same result as the whole text.
+    //! @return the separator offset or in_size if there isn't any separator.
+    static qint64 findWordBoundary(const char* in_data, qint64 in_size, qint64 in_from);
+
+    //! Checks if the given character divides words.
+    //! ASCII characters are classified as the "[[:space:][:punct:]]" class in the "C" locale.
+    //! Other characters are separators if they are Unicode spaces, punctuation or symbols.
+    static bool isSeparator(uint in_codePoint);
+
+private:
+    enum EUtf8State : uchar
+    {
+        eusAccept = 0,
+        eusReject = 1
+    };
+
+    static const uchar s_byteClasses[256];          //!< Byte classes of the UTF-8 decoding state machine.
+    static const uchar s_leadByteMasks[];           //!< Payload masks of the lead bytes by byte classes.
+    static const uchar s_utf8Transitions[];         //!< Transitions of the UTF-8 decoding state machine indexed by state and byte class.
+    static const uchar s_asciiSeparators[128];
+
+    static constexpr uint MaxCodePoint = 0x10FFFF;
+    using SeparatorsTable = std::array<quint64, (MaxCodePoint + 1) / 64>;
+
+    //! Returns the bit set of Unicode separators. It's built on the first use rather than at the static initialization,
+    //! so programs, which don't tokenize non-ASCII text, don't classify all code points at the start.
+    static const SeparatorsTable& separators();
+    static SeparatorsTable buildSeparatorsTable();
+
+    template <typename TWordHandler>
+    void processCharacter(uint in_codePoint, const char* in_chunkBegin, const char* in_characterBegin, const char*& inout_wordBegin, TWordHandler& in_onWord);
+
+    QByteArray m_pending;                           //!< The word head and the incomplete UTF-8 sequence divided by chunks' boundary.
+                                                    //!< Its capacity is reserved, so resizing to zero doesn't free the buffer.
+    qint64 m_pendingSequenceSize { 0 };             //!< The size of the incomplete UTF-8 sequence at the end of the pending data.
+    uint m_codePoint { 0 };
+    uchar m_utf8State { eusAccept };
+    bool m_isInWord { false };
+};
+
+inline bool CWordTokenizer::isSeparator(uint in_codePoint)
+{
+    if (in_codePoint < 128) {
+        return s_asciiSeparators[in_codePoint];
+    }
+    return in_codePoint <= MaxCodePoint && ((separators()[in_codePoint >> 6] >> (in_codePoint & 63)) & 1);
+}
+
+inline const CWordTokenizer::SeparatorsTable& CWordTokenizer::separators()
+{
+    static const SeparatorsTable separatorsTable = buildSeparatorsTable();
+    return separatorsTable;
+}
+
+template <typename TWordHandler>
+void CWordTokenizer::feed(const char* in_data, qint64 in_size, TWordHandler&& in_onWord)
+{
+    const char* it = in_data;
+    const char* end = in_data + in_size;
+    const char* wordBegin = m_isInWord ? in_data : nullptr;
+    const char* sequenceBegin = nullptr;    // nullptr if the current sequence has been started in a previous chunk.
+    while (it < end) {
+        const uchar byte = static_cast<uchar>(*it);
+
+        // ASCII fast path.
+        if (m_utf8State == eusAccept && byte < 128) {
+            processCharacter(byte, in_data, it, wordBegin, in_onWord);
+            ++it;
+            continue;
+        }
+
+        const uchar byteClass = s_byteClasses[byte];
+        if (m_utf8State == eusAccept) {
+            sequenceBegin = it;
+            m_codePoint = byte & s_leadByteMasks[byteClass];
+        } else {
+            m_codePoint = (m_codePoint << 6) | (byte & 0x3F);
+        }
+        m_utf8State = s_utf8Transitions[m_utf8State * 12 + byteClass];
+
+        if (m_utf8State == eusReject) {
+            // An invalid sequence is decoded as the replacement character. If the byte doesn't start the sequence,
+            // then it's processed again as the beginning of the next one.
+            m_utf8State = eusAccept;
+            const bool isLeadByte = sequenceBegin == it;
+            processCharacter(QChar::ReplacementCharacter, in_data, sequenceBegin, wordBegin, in_onWord);
+            sequenceBegin = nullptr;
+            if (isLeadByte) {
+                ++it;
+            }
+            continue;
+        }
+        if (m_utf8State == eusAccept) {
+            processCharacter(m_codePoint, in_data, sequenceBegin, wordBegin, in_onWord);
+        }
+        ++it;
+    }
+
+    // Keep the word head and the incomplete sequence until the next chunk.
+    if (m_isInWord) {
+        m_pending.append(wordBegin, static_cast<int>(end - wordBegin));
+    } else if (m_utf8State != eusAccept) {
+        const char* pendingBegin = sequenceBegin ? sequenceBegin : in_data;
+        m_pending.append(pendingBegin, static_cast<int>(end - pendingBegin));
+    }
+    if (m_utf8State != eusAccept) {
+        m_pendingSequenceSize = sequenceBegin ? end - sequenceBegin : m_pendingSequenceSize + in_size;
+    }
+}
+
+template <typename TWordHandler>
+void CWordTokenizer::finish(TWordHandler&& in_onWord)
+{
+    // The incomplete sequence at the end of the text is the replacement character, which is a separator.
+    if (m_isInWord) {
+        m_pending.chop(static_cast<int>(m_pendingSequenceSize));
+        if (!m_pending.isEmpty()) {
+            in_onWord(m_pending.constData(), m_pending.size());
+        }
+    }
+    reset();
+}
+
+template <typename TWordHandler>
+void CWordTokenizer::processCharacter(uint in_codePoint, const char* in_chunkBegin, const char* in_characterBegin, const char*& inout_wordBegin, TWordHandler& in_onWord)
+{
+    // The character begins in a previous chunk if in_characterBegin is nullptr. Its leading bytes are at the end of the pending data.
+    if (!isSeparator(in_codePoint)) {
+        if (!m_isInWord) {
+            m_isInWord = true;
+            inout_wordBegin = in_characterBegin ? in_characterBegin : in_chunkBegin;
+        }
+    } else if (m_isInWord) {
+        if (!m_pending.isEmpty()) {
+            // Assemble the word divided by chunks' boundary.
+            if (in_characterBegin) {
+                m_pending.append(in_chunkBegin, static_cast<int>(in_characterBegin - in_chunkBegin));
+            } else {
+                m_pending.chop(static_cast<int>(m_pendingSequenceSize));
+            }
+            in_onWord(m_pending.constData(), m_pending.size());
+            m_pending.resize(0);
+        } else {
+            in_onWord(inout_wordBegin, static_cast<int>(in_characterBegin - inout_wordBegin));
+        }
+        m_isInWord = false;
+        inout_wordBegin = nullptr;
+    } else if (!in_characterBegin) {
+        m_pending.resize(0);
+    }
+    if (!in_characterBegin) {
+        m_pendingSequenceSize = 0;
+    }
+}
+
+#endif // WORDTOKENIZER_H
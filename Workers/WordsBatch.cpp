@@ -0,0 +1,72 @@
+#include "WordsBatch.h"
+
+#include <QHash>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+    constexpr int InitialIndexSize = 1024;
+    constexpr int InitialTextCapacity = 64 * 1024;
+
+} // namespace
+
+CWordsBatch::CWordsBatch()
+    : m_index(InitialIndexSize, -1)
+{
+    m_text.reserve(InitialTextCapacity);
+}
+
+void CWordsBatch::addWord(const char* in_word, int in_size, quint64 in_count)
+{
+    const uint hash = qHashBits(in_word, static_cast<size_t>(in_size));
+    const size_t mask = m_index.size() - 1;
+    for (size_t slot = hash & mask; ; slot = (slot + 1) & mask) {
+        const int wordIndex = m_index[slot];
+        if (wordIndex < 0) {
+            m_index[slot] = static_cast<int>(m_words.size());
+            m_words.push_back({ m_text.size(), in_size, in_count, hash });
+            m_text.append(in_word, in_size);
+            break;
+        }
+        const SWord& word = m_words[wordIndex];
+        if (word.hash == hash && word.size == in_size && !std::memcmp(m_text.constData() + word.offset, in_word, static_cast<size_t>(in_size))) {
+            m_words[wordIndex].count += in_count;
+            return;
+        }
+    }
+
+    // Keep the load factor below one half.
+    if (m_words.size() * 2 > m_index.size()) {
+        growIndex();
+    }
+}
+
+void CWordsBatch::merge(const CWordsBatch& in_batch)
+{
+    for (int i = 0; i < in_batch.size(); ++i) {
+        addWord(in_batch.wordData(i), in_batch.wordSize(i), in_batch.wordCount(i));
+    }
+}
+
+void CWordsBatch::clear()
+{
+    m_text.resize(0);
+    m_words.clear();
+    std::fill(std::begin(m_index), std::end(m_index), -1);
+    m_resumeOffset = -1;
+}
+
+void CWordsBatch::growIndex()
+{
+    m_index.assign(m_index.size() * 2, -1);
+    const size_t mask = m_index.size() - 1;
+    for (size_t i = 0; i < m_words.size(); ++i) {
+        size_t slot = m_words[i].hash & mask;
+        while (m_index[slot] >= 0) {
+            slot = (slot + 1) & mask;
+        }
+        m_index[slot] = static_cast<int>(i);
+    }
+}
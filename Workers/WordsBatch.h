@@ -0,0 +1,59 @@
+#ifndef WORDSBATCH_H
+#define WORDSBATCH_H
+
+#include <QByteArray>
+
+#include <vector>
+
+//! The CWordsBatch class counts words passed from the file reader to the text analyzer.
+//! Words are stored in one contiguous text buffer and found by an open addressing index. Clearing keeps the allocated memory,
+//! so a reused batch doesn't allocate memory once it has grown to the typical size.
+class CWordsBatch
+{
+public:
+    CWordsBatch();
+
+    //! Adds the given UTF-8 word or increases its count.
+    void addWord(const char* in_word, int in_size, quint64 in_count = 1);
+
+    //! Adds words of the given batch.
+    void merge(const CWordsBatch& in_batch);
+
+    //! Removes all words and keeps the allocated memory.
+    void clear();
+
+    //! Returns the number of distinct words.
+    int size() const { return static_cast<int>(m_words.size()); }
+    bool isEmpty() const { return m_words.empty(); }
+
+    //! Returns the word's data, which is valid until the batch is cleared.
+    const char* wordData(int in_index) const { return m_text.constData() + m_words[in_index].offset; }
+    int wordSize(int in_index) const { return m_words[in_index].size; }
+    quint64 wordCount(int in_index) const { return m_words[in_index].count; }
+
+    //! Returns the size of the words' text in bytes.
+    int textSize() const { return m_text.size(); }
+
+    //! The offset in the file, from which reading may be resumed once words of this and all previous batches are counted.
+    //! It's -1 if reading can't be resumed after the batch.
+    void setResumeOffset(qint64 in_offset) { m_resumeOffset = in_offset; }
+    qint64 resumeOffset() const { return m_resumeOffset; }
+
+private:
+    struct SWord
+    {
+        int offset;
+        int size;
+        quint64 count;
+        uint hash;
+    };
+
+    void growIndex();
+
+    QByteArray m_text;                  //!< Words' text one after another. Its capacity is reserved, so resizing to zero doesn't free the buffer.
+    std::vector<SWord> m_words;
+    std::vector<int> m_index;           //!< Open addressing index of words, -1 marks an empty slot. Its size is a power of two.
+    qint64 m_resumeOffset { -1 };
+};
+
+#endif // WORDSBATCH_H
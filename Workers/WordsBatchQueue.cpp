@@ -0,0 +1,158 @@
+#include "WordsBatchQueue.h"
+
+#include <QThread>
+
+CWordsBatchQueue::CRing::CRing(int in_capacity)
+    : m_slots(static_cast<size_t>(in_capacity), nullptr)
+{}
+
+bool CWordsBatchQueue::CRing::push(CWordsBatch* in_batch)
+{
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) == m_slots.size()) {
+        return false;
+    }
+    m_slots[tail % m_slots.size()] = in_batch;
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+CWordsBatch* CWordsBatchQueue::CRing::pop()
+{
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    CWordsBatch* batch = m_slots[head % m_slots.size()];
+    m_head.store(head + 1, std::memory_order_release);
+    return batch;
+}
+
+int CWordsBatchQueue::CRing::size() const
+{
+    return static_cast<int>(m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire));
+}
+
+template <typename TIsReady>
+void CWordsBatchQueue::wait(int& inout_attempt, const TIsReady& in_isReady)
+{
+    constexpr int yieldAttempts = 64;
+    if (++inout_attempt < yieldAttempts) {
+        QThread::yieldCurrentThread();
+        return;
+    }
+
+    // The waiter is registered before the condition is checked, and the other side changes the queue before it checks waiters,
+    // so either the condition holds here or the other side sees the waiter and wakes it up under the mutex.
+    QMutexLocker locker(&m_mutex);
+    m_waitersCount.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!in_isReady()) {
+        m_condition.wait(&m_mutex);
+    }
+    m_waitersCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void CWordsBatchQueue::wakeUp()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_waitersCount.load(std::memory_order_relaxed) > 0) {
+        QMutexLocker locker(&m_mutex);
+        m_condition.wakeAll();
+    }
+}
+
+
+CWordsBatchQueue::CWordsBatchQueue(int in_batchesCount)
+    : m_filledBatches(in_batchesCount)
+    , m_freeBatches(in_batchesCount)
+{
+    for (int i = 0; i < in_batchesCount; ++i) {
+        m_freeBatches.push(new CWordsBatch());
+    }
+}
+
+CWordsBatchQueue::~CWordsBatchQueue()
+{
+    while (CWordsBatch* batch = m_filledBatches.pop()) {
+        delete batch;
+    }
+    while (CWordsBatch* batch = m_freeBatches.pop()) {
+        delete batch;
+    }
+}
+
+std::unique_ptr<CWordsBatch> CWordsBatchQueue::acquire()
+{
+    int attempt = 0;
+    while (!m_isAborted.load(std::memory_order_acquire)) {
+        if (CWordsBatch* batch = m_freeBatches.pop()) {
+            return std::unique_ptr<CWordsBatch>(batch);
+        }
+        wait(attempt, [this](){
+            return m_freeBatches.size() > 0 || m_isAborted.load(std::memory_order_acquire);
+        });
+    }
+    return nullptr;
+}
+
+void CWordsBatchQueue::push(std::unique_ptr<CWordsBatch> in_batch)
+{
+    m_filledBatches.push(in_batch.release());
+    wakeUp();
+}
+
+void CWordsBatchQueue::close()
+{
+    m_isClosed.store(true, std::memory_order_release);
+    wakeUp();
+}
+
+std::unique_ptr<CWordsBatch> CWordsBatchQueue::pop()
+{
+    int attempt = 0;
+    while (!m_isAborted.load(std::memory_order_acquire)) {
+        if (CWordsBatch* batch = m_filledBatches.pop()) {
+            return std::unique_ptr<CWordsBatch>(batch);
+        }
+        // The producer closes the queue after the last push, so the ring has to be checked once more.
+        if (m_isClosed.load(std::memory_order_acquire)) {
+            CWordsBatch* batch = m_filledBatches.pop();
+            return std::unique_ptr<CWordsBatch>(batch);
+        }
+        wait(attempt, [this](){
+            return m_filledBatches.size() > 0 || m_isClosed.load(std::memory_order_acquire) || m_isAborted.load(std::memory_order_acquire);
+        });
+    }
+    return nullptr;
+}
+
+void CWordsBatchQueue::release(std::unique_ptr<CWordsBatch> in_batch)
+{
+    in_batch->clear();
+    m_freeBatches.push(in_batch.release());
+    wakeUp();
+}
+
+void CWordsBatchQueue::abort()
+{
+    m_isAborted.store(true, std::memory_order_release);
+    wakeUp();
+}
+
+void CWordsBatchQueue::reset()
+{
+    while (CWordsBatch* batch = m_filledBatches.pop()) {
+        batch->clear();
+        m_freeBatches.push(batch);
+    }
+    m_isClosed.store(false, std::memory_order_release);
+    m_isAborted.store(false, std::memory_order_release);
+    wakeUp();
+}
+
+int CWordsBatchQueue::queuedBatchesCount() const
+{
+    return m_filledBatches.size();
+}
+
@@ -0,0 +1,87 @@
+#ifndef WORDSBATCHQUEUE_H
+#define WORDSBATCHQUEUE_H
+
+#include "WordsBatch.h"
+
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+//! The CWordsBatchQueue class passes words batches from the file reader (producer) to the text analyzer (consumer).
+//! The queue owns a fixed number of batches, which circulate between two lock-free single-producer/single-consumer rings:
+//! filled batches go to the consumer and processed batches go back to the pool of free ones. The producer waits while
+//! all batches are in use, so memory consumption is bounded and batches are reused without allocations.
+//! A waiting side yields for a while, then blocks on the condition variable. The other side locks the mutex to wake it up
+//! only if somebody blocks, so passing of batches stays lock-free while both sides are busy, and an idle followed file doesn't wake threads.
+class CWordsBatchQueue
+{
+public:
+    static constexpr int DefaultBatchesCount = 4;
+
+    explicit CWordsBatchQueue(int in_batchesCount = DefaultBatchesCount);
+    ~CWordsBatchQueue();
+
+    //! Takes a cleared batch from the pool. Waits while all batches are in use. It's called by the producer.
+    //! @return nullptr if the queue has been aborted.
+    std::unique_ptr<CWordsBatch> acquire();
+
+    //! Passes the filled batch to the consumer. It's called by the producer.
+    void push(std::unique_ptr<CWordsBatch> in_batch);
+
+    //! Informs the consumer that no more batches will be pushed. It's called by the producer.
+    void close();
+
+    //! Takes the next filled batch. Waits while the queue is empty. It's called by the consumer.
+    //! @return nullptr if the queue is closed and empty or has been aborted.
+    std::unique_ptr<CWordsBatch> pop();
+
+    //! Returns the processed batch to the pool. It's called by the consumer.
+    void release(std::unique_ptr<CWordsBatch> in_batch);
+
+    //! Wakes up the waiting producer and consumer, acquire() and pop() return nullptr afterwards. This method is thread safe.
+    void abort();
+
+    //! Returns queued batches to the pool and reopens the queue. It's called by the consumer before the producer is started,
+    //! e.g. by CTextAnalyzerWorker::resume(), or by the thread driving both sides, so neither side uses the queue meanwhile.
+    void reset();
+
+    //! Returns the number of filled batches waiting for the consumer. This method is thread safe.
+    int queuedBatchesCount() const;
+
+private:
+    //! The lock-free single-producer/single-consumer ring of batches. Its capacity is the number of batches, so it's never full.
+    class CRing
+    {
+    public:
+        explicit CRing(int in_capacity);
+
+        bool push(CWordsBatch* in_batch);
+        CWordsBatch* pop();
+        int size() const;
+
+    private:
+        std::vector<CWordsBatch*> m_slots;
+        std::atomic<size_t> m_head { 0 };   //!< The index of the next batch to pop. It's changed by the consumer only.
+        std::atomic<size_t> m_tail { 0 };   //!< The index of the next batch to push. It's changed by the producer only.
+    };
+
+    //! Yields the thread on the first attempts, then blocks until the other side changes the queue and the given condition may hold.
+    template <typename TIsReady>
+    void wait(int& inout_attempt, const TIsReady& in_isReady);
+
+    //! Wakes up the blocked side after the queue has been changed.
+    void wakeUp();
+
+    CRing m_filledBatches;
+    CRing m_freeBatches;
+    std::atomic<bool> m_isClosed { false };
+    std::atomic<bool> m_isAborted { false };
+    std::atomic<int> m_waitersCount { 0 };      //!< The number of threads blocked or going to block on the condition variable.
+    QMutex m_mutex;
+    QWaitCondition m_condition;
+};
+
+#endif // WORDSBATCHQUEUE_H
@@ -0,0 +1,126 @@
+#include "WordsCombinationsCache.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+    //! Offsets in the arena are 32-bit.
+    constexpr qint64 MaxCapacity = static_cast<qint64>(0xFFFFFFFF) * sizeof(CWordsCombinationsCache::SLetterCombination);
+
+    //! Returns the approximate memory taken by the cached word in bytes including its entry and the interner's overhead.
+    size_t wordMemoryUsage(int in_wordSize, size_t in_letterCombinationsCount)
+    {
+        return static_cast<size_t>(in_wordSize) + 2 * sizeof(quint64) + 5 * sizeof(quint32)
+                + in_letterCombinationsCount * sizeof(CWordsCombinationsCache::SLetterCombination);
+    }
+
+} // namespace
+
+CWordsCombinationsCache::CWordsCombinationsCache(qint64 in_capacity)
+{
+    setCapacity(in_capacity);
+}
+
+void CWordsCombinationsCache::setCapacity(qint64 in_capacity)
+{
+    m_capacity = std::clamp(in_capacity, static_cast<qint64>(0), MaxCapacity);
+    clear();
+}
+
+bool CWordsCombinationsCache::find(const char* in_word, int in_size, quint64 in_hash, const SLetterCombination*& out_begin, const SLetterCombination*& out_end)
+{
+    const quint32 id = m_capacity ? m_words.find(in_word, in_size, in_hash) : CStringInterner::InvalidId;
+    if (id == CStringInterner::InvalidId) {
+        ++m_missesCount;
+        return false;
+    }
+
+    ++m_hitsCount;
+    SEntry& entry = m_entries[id];
+    if (entry.hitsCount != 0xFFFFFFFF) {
+        ++entry.hitsCount;
+    }
+    out_begin = m_letterCombinations.data() + entry.offset;
+    out_end = out_begin + entry.size;
+    return true;
+}
+
+void CWordsCombinationsCache::insert(const char* in_word, int in_size, quint64 in_hash, const std::vector<SLetterCombination>& in_letterCombinations)
+{
+    const size_t insertedMemoryUsage = wordMemoryUsage(in_size, in_letterCombinations.size());
+    if (insertedMemoryUsage > static_cast<size_t>(m_capacity) / 2) {
+        return;
+    }
+    if (memoryUsage() + insertedMemoryUsage > static_cast<size_t>(m_capacity)) {
+        evict();
+    }
+
+    bool isAdded = false;
+    m_words.intern(in_word, in_size, in_hash, isAdded);
+    Q_ASSERT(isAdded);
+    m_entries.push_back({ static_cast<quint32>(m_letterCombinations.size()), static_cast<quint32>(in_letterCombinations.size()), 0 });
+    m_letterCombinations.insert(std::end(m_letterCombinations), std::begin(in_letterCombinations), std::end(in_letterCombinations));
+}
+
+void CWordsCombinationsCache::clear()
+{
+    m_words.clear();
+    m_entries.clear();
+    m_letterCombinations.clear();
+}
+
+void CWordsCombinationsCache::reset()
+{
+    clear();
+    m_hitsCount = 0;
+    m_missesCount = 0;
+    m_evictionsCount = 0;
+}
+
+double CWordsCombinationsCache::hitRate() const
+{
+    const quint64 lookupsCount = m_hitsCount + m_missesCount;
+    return lookupsCount ? static_cast<double>(m_hitsCount) / lookupsCount : 0.0;
+}
+
+size_t CWordsCombinationsCache::memoryUsage() const
+{
+    return m_words.memoryUsage() + m_entries.size() * sizeof(SEntry) + m_letterCombinations.size() * sizeof(SLetterCombination);
+}
+
+void CWordsCombinationsCache::evict()
+{
+    // Words are kept in hits descending order, equally hit words are kept in adding order, so older words win ties.
+    std::vector<quint32> ids(m_entries.size());
+    std::iota(std::begin(ids), std::end(ids), 0);
+    std::stable_sort(std::begin(ids), std::end(ids), [this](quint32 lhs, quint32 rhs){
+        return m_entries[lhs].hitsCount > m_entries[rhs].hitsCount;
+    });
+
+    CStringInterner words;
+    std::vector<SEntry> entries;
+    std::vector<SLetterCombination> letterCombinations;
+    const size_t targetMemoryUsage = static_cast<size_t>(m_capacity) / 2;
+    size_t memoryUsage = 0;
+    for (const auto id : ids) {
+        const SEntry& entry = m_entries[id];
+        const int wordSize = m_words.size(id);
+        const size_t keptMemoryUsage = wordMemoryUsage(wordSize, entry.size);
+        if (memoryUsage + keptMemoryUsage > targetMemoryUsage) {
+            break;
+        }
+        memoryUsage += keptMemoryUsage;
+
+        bool isAdded = false;
+        words.intern(m_words.data(id), wordSize, CStringInterner::hash(m_words.data(id), wordSize), isAdded);
+        entries.push_back({ static_cast<quint32>(letterCombinations.size()), entry.size, entry.hitsCount / 2 });
+        letterCombinations.insert(std::end(letterCombinations), m_letterCombinations.begin() + entry.offset,
+                                  m_letterCombinations.begin() + entry.offset + entry.size);
+    }
+
+    m_evictionsCount += m_entries.size() - entries.size();
+    m_words = std::move(words);
+    m_entries = std::move(entries);
+    m_letterCombinations = std::move(letterCombinations);
+}
@@ -0,0 +1,78 @@
+#ifndef WORDSCOMBINATIONSCACHE_H
+#define WORDSCOMBINATIONSCACHE_H
+
+#include "StringInterner.h"
+
+#include <QtGlobal>
+
+#include <vector>
+
+//! The CWordsCombinationsCache class memoizes distinct letter combinations of analyzed words, so letter combinations of a repeated word
+//! aren't enumerated and looked up in the dictionary again. Every word maps to a span of (identifier, multiplicity) pairs in a flat arena.
+//! The cache is bounded by its capacity in bytes. When it's full, the most rarely hit words are evicted, so frequent words stay in the cache,
+//! while the rare ones don't take more memory than the capacity.
+class CWordsCombinationsCache
+{
+public:
+    //! The distinct letter combination of a word.
+    struct SLetterCombination
+    {
+        quint32 id;     //!< The identifier in the dictionary.
+        quint32 count;  //!< The number of occurrences in the word.
+    };
+
+    static constexpr qint64 DefaultCapacity = 64 * 1024 * 1024;
+
+    explicit CWordsCombinationsCache(qint64 in_capacity = DefaultCapacity);
+
+    //! Sets the capacity in bytes and removes all words. Zero capacity disables the cache.
+    void setCapacity(qint64 in_capacity);
+    qint64 capacity() const { return m_capacity; }
+
+    //! Finds letter combinations of the given word. The result is counted as a hit or a miss.
+    //! @param in_hash [in] - the hash of the word calculated by CStringInterner::hash().
+    //! @param out_begin, out_end [out] - the span of letter combinations, which is valid until the next word is added.
+    //! @return false if the word is missing.
+    bool find(const char* in_word, int in_size, quint64 in_hash, const SLetterCombination*& out_begin, const SLetterCombination*& out_end);
+
+    //! Adds letter combinations of the missing word. Rarely hit words are evicted if the capacity is exceeded.
+    //! The word isn't added if its letter combinations don't fit into the capacity.
+    void insert(const char* in_word, int in_size, quint64 in_hash, const std::vector<SLetterCombination>& in_letterCombinations);
+
+    //! Removes all words, e.g. when identifiers of the dictionary become invalid. Statistics are kept.
+    void clear();
+
+    //! Removes all words and resets statistics.
+    void reset();
+
+    quint64 hitsCount() const { return m_hitsCount; }
+    quint64 missesCount() const { return m_missesCount; }
+    quint64 evictionsCount() const { return m_evictionsCount; }
+
+    //! Returns the share of hits in all lookups from zero to one.
+    double hitRate() const;
+
+    //! Returns the approximate memory taken by the cache in bytes.
+    size_t memoryUsage() const;
+
+private:
+    struct SEntry
+    {
+        quint32 offset;     //!< The offset of the word's letter combinations in the arena.
+        quint32 size;       //!< The number of the word's letter combinations.
+        quint32 hitsCount;  //!< Hits since the word has been added. Halved on every eviction to forget old popularity.
+    };
+
+    //! Keeps the most frequently hit words, which take up to half of the capacity, and compacts the arena.
+    void evict();
+
+    qint64 m_capacity { DefaultCapacity };
+    CStringInterner m_words;                                //!< Cached words. Their identifiers index entries.
+    std::vector<SEntry> m_entries;
+    std::vector<SLetterCombination> m_letterCombinations;   //!< Letter combinations of cached words one after another.
+    quint64 m_hitsCount { 0 };
+    quint64 m_missesCount { 0 };
+    quint64 m_evictionsCount { 0 };
+};
+
+#endif // WORDSCOMBINATIONSCACHE_H
@@ -1,5 +1,7 @@
 #include "TextAnalyzerWindow.h"
 #include "CommonData.h"
+#include "Workers/Tracing.h"
+#include "Workers/AllocationProfiler.h"
 
 #include <QApplication>
 
@@ -13,10 +15,23 @@ int main(int argc, char *argv[])
     font.setPixelSize(qRound(14 * fontMetrics.fontDpi() / CommonData::LogicalDpiRefValue));
     a.setFont(font);
 
-    qRegisterMetaType<WordsMap>("WordsMap");
     qRegisterMetaType<WordsVector>("WordsVector");
 
+    // Spans of the pipeline's threads are written to the file given by the environment variable when the application quits.
+    const QString traceFileName = qEnvironmentVariable("TEXTANALYZER_TRACE");
+    Tracing::SetEnabled(!traceFileName.isEmpty());
+
+    // Allocations are accounted by pipeline stages if the environment variable is set, the summary is shown in the status tooltip.
+    AllocationProfiler::SetEnabled(!qEnvironmentVariableIsEmpty("TEXTANALYZER_ALLOCATIONS"));
+    if (AllocationProfiler::IsEnabled() && !AllocationProfiler::IsAvailable()) {
+        qWarning("Allocations aren't accounted, the application is built without CONFIG+=allocation_profiling.");
+    }
+
     CTextAnalyzerWindow w;
     w.show();
-    return a.exec();
+    const int exitCode = a.exec();
+    if (!traceFileName.isEmpty() && !Tracing::Write(traceFileName)) {
+        qWarning("Failed to write the trace.");
+    }
+    return exitCode;
 }